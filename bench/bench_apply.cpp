@@ -0,0 +1,85 @@
+#include "benchmarks.hpp"
+
+// The layout argument of the elementwise benchmarks picks the rhs operand
+enum RhsLayout: index_t {
+    // both n x n and row-major
+    Contiguous,
+
+    // rhs is a transposed n x n
+    Transposed,
+
+    // rhs is a 1 x n row broadcast down n rows
+    Broadcast
+};
+
+template <typename T>
+static Tensor<T> bench_rhs(index_t n, index_t layout) {
+    switch (layout) {
+    case Transposed:
+        return transpose(bench_tensor<T>({n, n}), {1, 0});
+    case Broadcast:
+        return bench_tensor<T>({1, n});
+    default:
+        return bench_tensor<T>({n, n});
+    }
+}
+
+static void layout_args(benchmark::internal::Benchmark *b) {
+    b->ArgsProduct({{64, 512, 2048}, {Contiguous, Transposed, Broadcast}});
+}
+
+// Args: {n, layout}
+template <typename T>
+static void BM_Apply(benchmark::State &state) {
+    index_t n = state.range(0);
+    auto lhs = bench_tensor<T>({n, n});
+    auto rhs = bench_rhs<T>(n, state.range(1));
+
+    for (auto _ : state) {
+        auto result = apply<T>(lhs, rhs, [](T a, T b) { return a + b; });
+        benchmark::DoNotOptimize(result.data());
+    }
+
+    set_processed<T>(state, n*n);
+}
+BENCHMARK_TEMPLATE(BM_Apply, float)->Apply(layout_args);
+BENCHMARK_TEMPLATE(BM_Apply, double)->Apply(layout_args);
+BENCHMARK_TEMPLATE(BM_Apply, int)->Apply(layout_args);
+
+// Args: {n, layout}. The in-place form needs matching shapes, so a broadcast
+// rhs is expanded with `broadcast_to` first.
+template <typename T>
+static void BM_IApply(benchmark::State &state) {
+    index_t n = state.range(0);
+    auto lhs = bench_tensor<T>({n, n});
+    auto rhs = bench_rhs<T>(n, state.range(1));
+    if (state.range(1) == Broadcast) rhs = broadcast_to(rhs, {n, n});
+
+    for (auto _ : state) {
+        iapply(lhs, rhs, [](T a, T b) { return b - a; });
+        benchmark::DoNotOptimize(lhs.data());
+    }
+
+    set_processed<T>(state, n*n);
+}
+BENCHMARK_TEMPLATE(BM_IApply, float)->Apply(layout_args);
+BENCHMARK_TEMPLATE(BM_IApply, double)->Apply(layout_args);
+BENCHMARK_TEMPLATE(BM_IApply, int)->Apply(layout_args);
+
+// Args: {n, layout}. A fused expression, evaluated by `assign`.
+template <typename T>
+static void BM_Expression(benchmark::State &state) {
+    index_t n = state.range(0);
+    auto a = bench_tensor<T>({n, n});
+    auto b = bench_rhs<T>(n, state.range(1));
+    auto c = bench_tensor<T>({n, n});
+
+    for (auto _ : state) {
+        Tensor<T> result = a + b - c;
+        benchmark::DoNotOptimize(result.data());
+    }
+
+    set_processed<T>(state, n*n);
+}
+BENCHMARK_TEMPLATE(BM_Expression, float)->Apply(layout_args);
+BENCHMARK_TEMPLATE(BM_Expression, double)->Apply(layout_args);
@@ -0,0 +1,31 @@
+#include <algorithm>
+
+#include "benchmarks.hpp"
+#include "format.hpp"
+
+// Args: {n, summarized}. Formats an n x n tensor to a string, in full or with
+// the default NumPy-style summary.
+template <typename T>
+static void BM_Format(benchmark::State &state) {
+    index_t n = state.range(0);
+    auto t = bench_tensor<T>({n, n});
+
+    auto &options = format_options();
+    auto threshold = options.threshold;
+    if (!state.range(1)) options.threshold = n*n;
+
+    for (auto _ : state) {
+        auto text = fmt::format("{}", t);
+        benchmark::DoNotOptimize(text.data());
+    }
+
+    // a summarized tensor only formats the edges of each dimension
+    bool summarize = index_t(n*n) > options.threshold;
+    index_t shown = summarize ? std::min(n, 2*options.edge_items) : n;
+
+    options.threshold = threshold;
+    set_processed<T>(state, shown*shown);
+}
+BENCHMARK_TEMPLATE(BM_Format, float)->ArgsProduct({{16, 256}, {0, 1}});
+BENCHMARK_TEMPLATE(BM_Format, double)->ArgsProduct({{16, 256}, {0, 1}});
+BENCHMARK_TEMPLATE(BM_Format, int)->ArgsProduct({{16, 256}, {0, 1}});
@@ -0,0 +1,67 @@
+#include "benchmarks.hpp"
+#include "index_generator.hpp"
+
+// Args: {n, transposed}. Walks an n x n tensor with `index_generator`, reading
+// each element through the tracked storage offset.
+template <typename T>
+static void BM_IndexGeneratorOffsets(benchmark::State &state) {
+    index_t n = state.range(0);
+    auto t = bench_tensor<T>({n, n});
+    if (state.range(1)) t = transpose(t, {1, 0});
+
+    auto data = t.data() - base_offset(t.view());
+    for (auto _ : state) {
+        T total = 0;
+        for (index_generator gen(t.view()); !gen.done(); gen.next()) {
+            total += data[gen.offset()];
+        }
+        benchmark::DoNotOptimize(total);
+    }
+
+    set_processed<T>(state, n*n);
+}
+BENCHMARK_TEMPLATE(BM_IndexGeneratorOffsets, float)
+    ->ArgsProduct({{64, 512, 2048}, {0, 1}});
+BENCHMARK_TEMPLATE(BM_IndexGeneratorOffsets, double)
+    ->ArgsProduct({{64, 512, 2048}, {0, 1}});
+
+// Args: {n}. Ranges over the indices of a 4-d shape and reads each element
+// through `operator()(indices)`.
+template <typename T>
+static void BM_IndexGeneratorRange(benchmark::State &state) {
+    index_t n = state.range(0);
+    auto t = bench_tensor<T>({n, n, n, n});
+
+    for (auto _ : state) {
+        T total = 0;
+        for (auto const &index : index_generator(t.shape())) {
+            total += t(index);
+        }
+        benchmark::DoNotOptimize(total);
+    }
+
+    set_processed<T>(state, n*n*n*n);
+}
+BENCHMARK_TEMPLATE(BM_IndexGeneratorRange, float)->Arg(8)->Arg(24);
+BENCHMARK_TEMPLATE(BM_IndexGeneratorRange, int)->Arg(8)->Arg(24);
+
+// Args: {n}. Reads every element of an n x n x n tensor with `t(i, j, k)`.
+template <typename T>
+static void BM_ElementAccess(benchmark::State &state) {
+    index_t n = state.range(0);
+    auto t = bench_tensor<T>({n, n, n});
+
+    for (auto _ : state) {
+        T total = 0;
+        for (index_t i = 0; i < n; i++) {
+            for (index_t j = 0; j < n; j++) {
+                for (index_t k = 0; k < n; k++) total += t(i, j, k);
+            }
+        }
+        benchmark::DoNotOptimize(total);
+    }
+
+    set_processed<T>(state, n*n*n);
+}
+BENCHMARK_TEMPLATE(BM_ElementAccess, float)->Arg(16)->Arg(64);
+BENCHMARK_TEMPLATE(BM_ElementAccess, int)->Arg(16)->Arg(64);
@@ -0,0 +1,55 @@
+#include "benchmarks.hpp"
+
+// Args: {n, transposed}. Reshapes an n x n tensor to n*n; a transposed
+// tensor has to be copied first.
+template <typename T>
+static void BM_Reshape(benchmark::State &state) {
+    index_t n = state.range(0);
+    auto t = bench_tensor<T>({n, n});
+    if (state.range(1)) t = transpose(t, {1, 0});
+
+    for (auto _ : state) {
+        auto result = reshape(t, {n*n});
+        benchmark::DoNotOptimize(result.data());
+    }
+
+    set_processed<T>(state, n*n);
+}
+BENCHMARK_TEMPLATE(BM_Reshape, float)->ArgsProduct({{64, 1024}, {0, 1}});
+BENCHMARK_TEMPLATE(BM_Reshape, double)->ArgsProduct({{64, 1024}, {0, 1}});
+
+// Args: {n, transposed}. Copies an n x n x n tensor, permuted with its
+// innermost dimension moved outward when `transposed` is set.
+template <typename T>
+static void BM_Copy(benchmark::State &state) {
+    index_t n = state.range(0);
+    auto t = bench_tensor<T>({n, n, n});
+    if (state.range(1)) t = transpose(t, {2, 0, 1});
+
+    for (auto _ : state) {
+        auto result = copy(t);
+        benchmark::DoNotOptimize(result.data());
+    }
+
+    set_processed<T>(state, n*n*n);
+}
+BENCHMARK_TEMPLATE(BM_Copy, float)->ArgsProduct({{16, 128}, {0, 1}});
+BENCHMARK_TEMPLATE(BM_Copy, double)->ArgsProduct({{16, 128}, {0, 1}});
+BENCHMARK_TEMPLATE(BM_Copy, int)->ArgsProduct({{16, 128}, {0, 1}});
+
+// Args: {n}. Slices every row of an n x n tensor and converts it to a Tensor.
+template <typename T>
+static void BM_SliceRows(benchmark::State &state) {
+    index_t n = state.range(0);
+    auto t = bench_tensor<T>({n, n});
+
+    for (auto _ : state) {
+        for (index_t i = 0; i < n; i++) {
+            Tensor<T> row = t[i];
+            benchmark::DoNotOptimize(row.data());
+        }
+    }
+
+    set_processed<T>(state, n*n);
+}
+BENCHMARK_TEMPLATE(BM_SliceRows, float)->Arg(64)->Arg(1024);
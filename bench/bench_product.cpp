@@ -0,0 +1,115 @@
+#include "benchmarks.hpp"
+
+// One benchmark per path through `product()`, each counting 2 flops per
+// multiply-add
+
+// Args: {n}
+template <typename T>
+static void BM_VectorVector(benchmark::State &state) {
+    index_t n = state.range(0);
+    auto lhs = bench_tensor<T>({n});
+    auto rhs = bench_tensor<T>({n});
+
+    for (auto _ : state) {
+        auto result = product(lhs, rhs);
+        benchmark::DoNotOptimize(result.data());
+    }
+
+    set_flops(state, 2.0*n);
+}
+BENCHMARK_TEMPLATE(BM_VectorVector, float)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(BM_VectorVector, double)->Arg(1 << 10)->Arg(1 << 20);
+
+// Args: {n, transposed}
+template <typename T>
+static void BM_MatrixVector(benchmark::State &state) {
+    index_t n = state.range(0);
+    auto lhs = bench_tensor<T>({n, n});
+    if (state.range(1)) lhs = transpose(lhs, {1, 0});
+    auto rhs = bench_tensor<T>({n});
+
+    for (auto _ : state) {
+        auto result = product(lhs, rhs);
+        benchmark::DoNotOptimize(result.data());
+    }
+
+    set_flops(state, 2.0*n*n);
+}
+BENCHMARK_TEMPLATE(BM_MatrixVector, float)->ArgsProduct({{64, 1024}, {0, 1}});
+BENCHMARK_TEMPLATE(BM_MatrixVector, double)->ArgsProduct({{64, 1024}, {0, 1}});
+
+// Args: {n}
+template <typename T>
+static void BM_VectorMatrix(benchmark::State &state) {
+    index_t n = state.range(0);
+    auto lhs = bench_tensor<T>({n});
+    auto rhs = bench_tensor<T>({n, n});
+
+    for (auto _ : state) {
+        auto result = product(lhs, rhs);
+        benchmark::DoNotOptimize(result.data());
+    }
+
+    set_flops(state, 2.0*n*n);
+}
+BENCHMARK_TEMPLATE(BM_VectorMatrix, float)->Arg(64)->Arg(1024);
+BENCHMARK_TEMPLATE(BM_VectorMatrix, double)->Arg(64)->Arg(1024);
+
+// Args: {n, transposed}
+template <typename T, typename Device=CPU>
+static void BM_MatrixMatrix(benchmark::State &state) {
+    index_t n = state.range(0);
+    auto lhs = bench_tensor<T, Device>({n, n});
+    if (state.range(1)) lhs = transpose(lhs, {1, 0});
+    auto rhs = bench_tensor<T, Device>({n, n});
+
+    for (auto _ : state) {
+        auto result = product(lhs, rhs);
+        benchmark::DoNotOptimize(result.data());
+    }
+
+    set_flops(state, 2.0*n*n*n);
+}
+BENCHMARK_TEMPLATE(BM_MatrixMatrix, float)->ArgsProduct({{16, 128, 512}, {0, 1}});
+BENCHMARK_TEMPLATE(BM_MatrixMatrix, double)->ArgsProduct({{16, 128, 512}, {0, 1}});
+BENCHMARK_TEMPLATE(BM_MatrixMatrix, int)->ArgsProduct({{16, 128}, {0}});
+#ifdef TENSOR_HAS_CBLAS
+BENCHMARK_TEMPLATE(BM_MatrixMatrix, float, CPU_BLAS)->ArgsProduct({{16, 128, 512}, {0, 1}});
+BENCHMARK_TEMPLATE(BM_MatrixMatrix, double, CPU_BLAS)->ArgsProduct({{16, 128, 512}, {0, 1}});
+#endif
+
+// Args: {batch, n, broadcast}. With `broadcast` set, rhs is a single n x n
+// matrix shared by every batch.
+template <typename T>
+static void BM_BatchMatrixMatrix(benchmark::State &state) {
+    index_t batch = state.range(0);
+    index_t n = state.range(1);
+    auto lhs = bench_tensor<T>({batch, n, n});
+    auto rhs = state.range(2) ? bench_tensor<T>({1, n, n}) : bench_tensor<T>({batch, n, n});
+
+    for (auto _ : state) {
+        auto result = product(lhs, rhs);
+        benchmark::DoNotOptimize(result.data());
+    }
+
+    set_flops(state, 2.0*batch*n*n*n);
+}
+BENCHMARK_TEMPLATE(BM_BatchMatrixMatrix, float)->ArgsProduct({{8, 64}, {16, 64}, {0, 1}});
+BENCHMARK_TEMPLATE(BM_BatchMatrixMatrix, double)->ArgsProduct({{8, 64}, {16, 64}, {0, 1}});
+
+// Args: {batch, n}. A vector times a batch of matrices.
+template <typename T>
+static void BM_BatchVectorMatrix(benchmark::State &state) {
+    index_t batch = state.range(0);
+    index_t n = state.range(1);
+    auto lhs = bench_tensor<T>({n});
+    auto rhs = bench_tensor<T>({batch, n, n});
+
+    for (auto _ : state) {
+        auto result = product(lhs, rhs);
+        benchmark::DoNotOptimize(result.data());
+    }
+
+    set_flops(state, 2.0*batch*n*n);
+}
+BENCHMARK_TEMPLATE(BM_BatchVectorMatrix, float)->ArgsProduct({{8, 64}, {64, 256}});
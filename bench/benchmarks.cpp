@@ -0,0 +1,27 @@
+#include <benchmark/benchmark.h>
+
+#include "simd.hpp"
+#include "thread_pool.hpp"
+
+static char const *simd_level_name(SimdLevel level) {
+    switch (level) {
+    case SimdLevel::SSE42: return "sse4.2";
+    case SimdLevel::AVX2: return "avx2";
+    case SimdLevel::AVX512: return "avx512";
+    default: return "generic";
+    }
+}
+
+int main(int argc, char **argv) {
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+
+    // recorded in the JSON output, so runs on different settings aren't
+    // compared by mistake
+    benchmark::AddCustomContext("tensor_simd_level", simd_level_name(simd_level()));
+    benchmark::AddCustomContext("tensor_threads", std::to_string(num_threads()));
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
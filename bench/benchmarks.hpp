@@ -0,0 +1,42 @@
+#ifndef BENCHMARKS_HPP
+#define BENCHMARKS_HPP
+
+#include <benchmark/benchmark.h>
+#include <fmt/format.h>
+#include <fmt/ranges.h>
+
+#include "tensor.hpp"
+#include "tensor_ops.hpp"
+
+/**
+ * @brief Returns a tensor of `shape` filled with small values, so products
+ *        and sums of every element type stay in range
+ */
+template <typename T, typename Device=CPU>
+Tensor<T, Device> bench_tensor(extent const &shape) {
+    Tensor<T, Device> t(shape);
+
+    index_t i = 0;
+    fill(t, [&i]() { return static_cast<T>(i++ % 7); });
+    return t;
+}
+
+/**
+ * @brief Records `elements` elements of `T` touched per iteration, so the
+ *        report includes items/s and bytes/s
+ */
+template <typename T>
+void set_processed(benchmark::State &state, index_t elements) {
+    state.SetItemsProcessed(state.iterations()*elements);
+    state.SetBytesProcessed(state.iterations()*elements*sizeof(T));
+}
+
+/**
+ * @brief Reports `flops` floating point operations per iteration as a rate
+ */
+inline void set_flops(benchmark::State &state, double flops) {
+    state.counters["FLOPS"] = benchmark::Counter(state.iterations()*flops,
+                                                 benchmark::Counter::kIsRate);
+}
+
+#endif
@@ -0,0 +1,323 @@
+#ifndef ALLOCATOR_HPP
+#define ALLOCATOR_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * Alignment, in bytes, of the memory backing `Storage<T, CPU>`. Defaults to a
+ * cache line, which is also the widest SIMD register (AVX-512).
+ */
+#ifndef TENSOR_STORAGE_ALIGNMENT
+#define TENSOR_STORAGE_ALIGNMENT 64
+#endif
+
+static_assert((TENSOR_STORAGE_ALIGNMENT & (TENSOR_STORAGE_ALIGNMENT - 1)) == 0,
+              "TENSOR_STORAGE_ALIGNMENT must be a power of two");
+
+/**
+ * @brief Allocation counters of a `CachingAllocator`
+ */
+struct CacheStats {
+    // allocations served from a cache
+    std::size_t hits;
+
+    // allocations passed on to the system allocator
+    std::size_t misses;
+
+    // bytes held in caches, free for reuse
+    std::size_t bytes_cached;
+};
+
+/**
+ * @brief Size-bucketed cache of aligned blocks, used for tensor storage.
+ *
+ * Freed blocks are kept and handed out again to later requests of the same
+ * bucket, so a loop that keeps creating tensors of the same shapes stops
+ * calling into the system allocator (and faulting in fresh pages) once it
+ * has warmed up. Each thread has its own cache of up to
+ * `thread_cache_limit()` bytes, which is used without contention; blocks
+ * beyond that, or freed by exited threads, go to a cache shared by all
+ * threads. Cached memory is only returned to the system by `trim()`.
+ *
+ * Caching can be turned off with `set_enabled(false)` or by setting the
+ * `TENSOR_CACHING_ALLOCATOR` environment variable to `0`.
+ */
+class CachingAllocator {
+public:
+    static constexpr std::size_t alignment = TENSOR_STORAGE_ALIGNMENT;
+
+    CachingAllocator(CachingAllocator const &) = delete;
+    CachingAllocator &operator =(CachingAllocator const &) = delete;
+
+    /**
+     * @brief Size of the block actually allocated for a request of `bytes`:
+     *        a multiple of `alignment`, with four buckets per power of two
+     *        so that at most a quarter of a block is wasted
+     */
+    static std::size_t bucket_size(std::size_t bytes) {
+        if (bytes <= alignment) return alignment;
+
+        std::size_t power = alignment;
+        while (power < bytes/2 + bytes%2) power *= 2;
+
+        std::size_t step = std::max(power/4, alignment);
+        return (bytes + step - 1)/step*step;
+    }
+
+    void *allocate(std::size_t bytes) {
+        auto size = bucket_size(bytes);
+
+        if (enabled()) {
+            if (auto cache = local_cache()) {
+                std::lock_guard<std::mutex> lock(cache->mutex);
+                if (auto block = take(cache->blocks, size)) {
+                    cache->bytes -= size;
+                    return block;
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(shared_mutex_);
+            if (auto block = take(shared_, size)) return block;
+        }
+
+        ++misses_;
+        return ::operator new(size, std::align_val_t(alignment));
+    }
+
+    void deallocate(void *block, std::size_t bytes) noexcept {
+        auto size = bucket_size(bytes);
+
+        if (!enabled()) {
+            ::operator delete(block, std::align_val_t(alignment));
+            return;
+        }
+
+        if (size <= thread_cache_limit()) {
+            if (auto cache = local_cache()) {
+                std::lock_guard<std::mutex> lock(cache->mutex);
+                if (cache->bytes + size <= thread_cache_limit()) {
+                    put(cache->blocks, block, size);
+                    cache->bytes += size;
+                    return;
+                }
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(shared_mutex_);
+        put(shared_, block, size);
+    }
+
+    /**
+     * @brief Returns every cached block, of every thread, to the system
+     */
+    void trim() {
+        std::lock_guard<std::mutex> registry_lock(registry_mutex_);
+
+        for (auto cache : registry_) {
+            std::lock_guard<std::mutex> lock(cache->mutex);
+            release(cache->blocks);
+            cache->bytes = 0;
+        }
+
+        std::lock_guard<std::mutex> lock(shared_mutex_);
+        release(shared_);
+    }
+
+    CacheStats stats() const {
+        return {hits_.load(), misses_.load(), bytes_cached_.load()};
+    }
+
+    bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Turns caching on or off. Blocks already cached stay cached
+     *        until `trim()`.
+     */
+    void set_enabled(bool enabled) { enabled_ = enabled; }
+
+    /**
+     * @brief Maximum number of bytes cached by each thread
+     */
+    std::size_t thread_cache_limit() const {
+        return thread_cache_limit_.load(std::memory_order_relaxed);
+    }
+
+    void set_thread_cache_limit(std::size_t bytes) { thread_cache_limit_ = bytes; }
+private:
+    friend CachingAllocator &caching_allocator();
+
+    using BlockMap = std::unordered_map<std::size_t, std::vector<void *>>;
+
+    struct ThreadCache {
+        std::mutex mutex;
+        BlockMap blocks;
+        std::size_t bytes = 0;
+    };
+
+    // registers the calling thread's cache, and hands its blocks over to the
+    // shared cache when the thread exits
+    struct ThreadCacheOwner {
+        ThreadCacheOwner(CachingAllocator &allocator, bool &exited):
+            allocator(allocator), cache(std::make_unique<ThreadCache>()), exited(exited)
+        {
+            std::lock_guard<std::mutex> lock(allocator.registry_mutex_);
+            allocator.registry_.push_back(cache.get());
+        }
+
+        ~ThreadCacheOwner() {
+            exited = true;
+
+            std::lock_guard<std::mutex> registry_lock(allocator.registry_mutex_);
+            auto &registry = allocator.registry_;
+            registry.erase(std::find(registry.begin(), registry.end(), cache.get()));
+
+            std::lock_guard<std::mutex> lock(allocator.shared_mutex_);
+            for (auto &bucket : cache->blocks) {
+                auto &shared = allocator.shared_[bucket.first];
+                shared.insert(shared.end(), bucket.second.begin(), bucket.second.end());
+            }
+        }
+
+        CachingAllocator &allocator;
+        std::unique_ptr<ThreadCache> cache;
+        bool &exited;
+    };
+
+    CachingAllocator() {
+        auto env = std::getenv("TENSOR_CACHING_ALLOCATOR");
+        enabled_ = !(env && std::strcmp(env, "0") == 0);
+    }
+
+    // null once the calling thread's cache has been torn down (e.g. while
+    // destroying other thread_local objects)
+    ThreadCache *local_cache() {
+        thread_local bool exited = false;
+        if (exited) return nullptr;
+
+        thread_local ThreadCacheOwner owner(*this, exited);
+
+        return owner.cache.get();
+    }
+
+    void *take(BlockMap &blocks, std::size_t size) {
+        auto bucket = blocks.find(size);
+        if (bucket == blocks.end() || bucket->second.empty()) return nullptr;
+
+        auto block = bucket->second.back();
+        bucket->second.pop_back();
+
+        ++hits_;
+        bytes_cached_ -= size;
+        return block;
+    }
+
+    void put(BlockMap &blocks, void *block, std::size_t size) {
+        blocks[size].push_back(block);
+        bytes_cached_ += size;
+    }
+
+    void release(BlockMap &blocks) {
+        for (auto &bucket : blocks) {
+            for (auto block : bucket.second) {
+                ::operator delete(block, std::align_val_t(alignment));
+            }
+            bytes_cached_ -= bucket.first*bucket.second.size();
+        }
+        blocks.clear();
+    }
+
+    std::atomic<bool> enabled_{true};
+    std::atomic<std::size_t> thread_cache_limit_{std::size_t(64) << 20};
+
+    std::atomic<std::size_t> hits_{0};
+    std::atomic<std::size_t> misses_{0};
+    std::atomic<std::size_t> bytes_cached_{0};
+
+    std::mutex registry_mutex_;
+    std::vector<ThreadCache *> registry_;
+
+    std::mutex shared_mutex_;
+    BlockMap shared_;
+};
+
+/**
+ * @brief The allocator used by tensor storage. Never destroyed, so storage
+ *        freed during static destruction is still handled.
+ */
+inline CachingAllocator &caching_allocator() {
+    static CachingAllocator *allocator = new CachingAllocator();
+    return *allocator;
+}
+
+#ifdef TENSOR_PROFILE
+namespace detail {
+
+// storage allocations made by the calling thread, for the profiler
+inline std::size_t &storage_allocations() {
+    thread_local std::size_t count = 0;
+    return count;
+}
+
+} // namespace detail
+#endif
+
+/**
+ * @brief Standard allocator drawing from `caching_allocator()`. Elements
+ *        constructed without arguments are default-initialized rather than
+ *        value-initialized, so `std::vector<T, PoolAllocator<T>>(n)` leaves
+ *        arithmetic elements uninitialized instead of zeroing them.
+ */
+template <typename T>
+struct PoolAllocator {
+    using value_type = T;
+
+    static_assert(alignof(T) <= CachingAllocator::alignment,
+                  "element type is over-aligned for tensor storage");
+
+    template <typename U>
+    struct rebind { using other = PoolAllocator<U>; };
+
+    PoolAllocator() noexcept = default;
+
+    template <typename U>
+    PoolAllocator(PoolAllocator<U> const &) noexcept {}
+
+    T *allocate(std::size_t n) {
+#ifdef TENSOR_PROFILE
+        ++detail::storage_allocations();
+#endif
+        return static_cast<T *>(caching_allocator().allocate(n*sizeof(T)));
+    }
+
+    void deallocate(T *p, std::size_t n) noexcept {
+        caching_allocator().deallocate(p, n*sizeof(T));
+    }
+
+    template <typename U>
+    void construct(U *p) {
+        ::new (static_cast<void *>(p)) U;
+    }
+
+    template <typename U, typename... Args>
+    void construct(U *p, Args &&... args) {
+        ::new (static_cast<void *>(p)) U(std::forward<Args>(args)...);
+    }
+
+    template <typename U>
+    bool operator ==(PoolAllocator<U> const &) const noexcept { return true; }
+
+    template <typename U>
+    bool operator !=(PoolAllocator<U> const &) const noexcept { return false; }
+};
+
+#endif
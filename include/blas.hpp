@@ -0,0 +1,170 @@
+#ifndef BLAS_HPP
+#define BLAS_HPP
+
+#include <algorithm>
+#include <climits>
+#include <type_traits>
+
+#ifdef TENSOR_HAS_CBLAS
+#include <cblas.h>
+#endif
+
+#include "types.hpp"
+#include "gemm.hpp"
+
+/**
+ * Thin wrappers over the system CBLAS used by `Tensor<T, CPU_BLAS>`.
+ *
+ * Each call returns false when it cannot be handled by BLAS (no BLAS at
+ * build time, an element type other than float/double, sizes that overflow
+ * `int`, or strides BLAS cannot express such as broadcast dimensions), in
+ * which case the caller falls back to the native kernels.
+ */
+namespace blas {
+
+/**
+ * @brief True if the library was built against a CBLAS implementation
+ *        (`TENSOR_HAS_CBLAS`)
+ */
+constexpr bool available() {
+#ifdef TENSOR_HAS_CBLAS
+    return true;
+#else
+    return false;
+#endif
+}
+
+namespace detail {
+
+template <typename T>
+constexpr bool supported_type = std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+inline bool fits(index_t value) {
+    return value <= index_t(INT_MAX);
+}
+
+// how a strided matrix is passed to a row-major BLAS call
+struct MatrixArgs {
+    bool valid;
+    bool transpose;
+    int ld;
+};
+
+template <typename T>
+MatrixArgs matrix_args(MatrixRef<T> m, index_t rows, index_t cols) {
+    if (m.col_stride == 1 && m.row_stride >= std::max<index_t>(cols, 1) && fits(m.row_stride)) {
+        return {true, false, int(m.row_stride)};
+    }
+
+    if (m.row_stride == 1 && m.col_stride >= std::max<index_t>(rows, 1) && fits(m.col_stride)) {
+        return {true, true, int(m.col_stride)};
+    }
+
+    return {false, false, 0};
+}
+
+} // namespace detail
+
+/**
+ * @brief `C += A*B` (see `::gemm`)
+ */
+template <typename T>
+bool gemm(index_t m, index_t n, index_t k,
+          MatrixRef<T const> a, MatrixRef<T const> b, MatrixRef<T> c)
+{
+#ifdef TENSOR_HAS_CBLAS
+    if constexpr (detail::supported_type<T>) {
+        if (!detail::fits(m) || !detail::fits(n) || !detail::fits(k)) return false;
+
+        auto a_args = detail::matrix_args(a, m, k);
+        auto b_args = detail::matrix_args(b, k, n);
+        auto c_args = detail::matrix_args(c, m, n);
+        if (!a_args.valid || !b_args.valid || !c_args.valid || c_args.transpose) return false;
+
+        if (m == 0 || n == 0 || k == 0) return true;
+
+        auto a_trans = a_args.transpose ? CblasTrans : CblasNoTrans;
+        auto b_trans = b_args.transpose ? CblasTrans : CblasNoTrans;
+
+        if constexpr (std::is_same_v<T, float>) {
+            cblas_sgemm(CblasRowMajor, a_trans, b_trans, int(m), int(n), int(k),
+                        1.0f, a.data, a_args.ld, b.data, b_args.ld,
+                        1.0f, c.data, c_args.ld);
+        } else {
+            cblas_dgemm(CblasRowMajor, a_trans, b_trans, int(m), int(n), int(k),
+                        1.0, a.data, a_args.ld, b.data, b_args.ld,
+                        1.0, c.data, c_args.ld);
+        }
+
+        return true;
+    }
+#endif
+    (void)m; (void)n; (void)k; (void)a; (void)b; (void)c;
+    return false;
+}
+
+/**
+ * @brief `y += A*x` (see `::gemv`)
+ */
+template <typename T>
+bool gemv(index_t m, index_t n, MatrixRef<T const> a,
+          T const *x, index_t x_stride, T *y, index_t y_stride)
+{
+#ifdef TENSOR_HAS_CBLAS
+    if constexpr (detail::supported_type<T>) {
+        if (!detail::fits(m) || !detail::fits(n)) return false;
+        if (x_stride == 0 || !detail::fits(x_stride)) return false;
+        if (y_stride == 0 || !detail::fits(y_stride)) return false;
+
+        auto a_args = detail::matrix_args(a, m, n);
+        if (!a_args.valid) return false;
+
+        if (m == 0 || n == 0) return true;
+
+        // a transposed A is passed as the n x m matrix it is stored as
+        auto trans = a_args.transpose ? CblasTrans : CblasNoTrans;
+        int rows = int(a_args.transpose ? n : m);
+        int cols = int(a_args.transpose ? m : n);
+
+        if constexpr (std::is_same_v<T, float>) {
+            cblas_sgemv(CblasRowMajor, trans, rows, cols, 1.0f, a.data, a_args.ld,
+                        x, int(x_stride), 1.0f, y, int(y_stride));
+        } else {
+            cblas_dgemv(CblasRowMajor, trans, rows, cols, 1.0, a.data, a_args.ld,
+                        x, int(x_stride), 1.0, y, int(y_stride));
+        }
+
+        return true;
+    }
+#endif
+    (void)m; (void)n; (void)a; (void)x; (void)x_stride; (void)y; (void)y_stride;
+    return false;
+}
+
+/**
+ * @brief Dot product (see `::dot`), stored in `result`
+ */
+template <typename T>
+bool dot(index_t n, T const *x, index_t x_stride, T const *y, index_t y_stride, T &result) {
+#ifdef TENSOR_HAS_CBLAS
+    if constexpr (detail::supported_type<T>) {
+        if (!detail::fits(n)) return false;
+        if (x_stride == 0 || !detail::fits(x_stride)) return false;
+        if (y_stride == 0 || !detail::fits(y_stride)) return false;
+
+        if constexpr (std::is_same_v<T, float>) {
+            result = cblas_sdot(int(n), x, int(x_stride), y, int(y_stride));
+        } else {
+            result = cblas_ddot(int(n), x, int(x_stride), y, int(y_stride));
+        }
+
+        return true;
+    }
+#endif
+    (void)n; (void)x; (void)x_stride; (void)y; (void)y_stride; (void)result;
+    return false;
+}
+
+} // namespace blas
+
+#endif
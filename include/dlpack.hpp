@@ -0,0 +1,193 @@
+#ifndef DLPACK_HPP
+#define DLPACK_HPP
+
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "tensor.hpp"
+#include "tensor_ops.hpp"
+
+#if __has_include(<dlpack/dlpack.h>)
+#include <dlpack/dlpack.h>
+#else
+// The subset of the DLPack (v0.8) ABI used here, for builds without the
+// DLPack headers. Layouts match dlpack/dlpack.h exactly.
+extern "C" {
+
+typedef enum {
+    kDLCPU = 1,
+    kDLCUDA = 2,
+    kDLCUDAHost = 3,
+} DLDeviceType;
+
+typedef struct {
+    DLDeviceType device_type;
+    int32_t device_id;
+} DLDevice;
+
+typedef enum {
+    kDLInt = 0U,
+    kDLUInt = 1U,
+    kDLFloat = 2U,
+    kDLOpaqueHandle = 3U,
+    kDLBfloat = 4U,
+    kDLComplex = 5U,
+    kDLBool = 6U,
+} DLDataTypeCode;
+
+typedef struct {
+    uint8_t code;
+    uint8_t bits;
+    uint16_t lanes;
+} DLDataType;
+
+typedef struct {
+    void *data;
+    DLDevice device;
+    int32_t ndim;
+    DLDataType dtype;
+    int64_t *shape;
+    int64_t *strides;
+    uint64_t byte_offset;
+} DLTensor;
+
+typedef struct DLManagedTensor {
+    DLTensor dl_tensor;
+    void *manager_ctx;
+    void (*deleter)(struct DLManagedTensor *self);
+} DLManagedTensor;
+
+} // extern "C"
+#endif
+
+struct UnsupportedDLPackTensor: public TensorError {
+    UnsupportedDLPackTensor(std::string const &reason):
+        TensorError(fmt::format("Cannot import DLPack tensor: {}", reason)) {}
+};
+
+/**
+ * @brief DLPack data type of elements of type `T`
+ */
+template <typename T>
+DLDataType dlpack_dtype() {
+    static_assert(std::is_arithmetic_v<T>, "DLPack only describes arithmetic element types");
+
+    uint8_t code;
+    if (std::is_same_v<T, bool>) {
+        code = kDLBool;
+    } else if (std::is_floating_point_v<T>) {
+        code = kDLFloat;
+    } else if (std::is_signed_v<T>) {
+        code = kDLInt;
+    } else {
+        code = kDLUInt;
+    }
+
+    return {code, uint8_t(sizeof(T)*8), 1};
+}
+
+/**
+ * @brief DLPack device type of tensors stored on `Device`
+ */
+template <typename Device>
+struct dlpack_device;
+
+template <>
+struct dlpack_device<CPU> {
+    static constexpr DLDeviceType type = kDLCPU;
+};
+
+template <>
+struct dlpack_device<CPU_BLAS> {
+    static constexpr DLDeviceType type = kDLCPU;
+};
+
+namespace detail {
+
+// owns everything a DLManagedTensor exported by `to_dlpack` points to; the
+// tensor keeps its storage alive until the consumer calls the deleter
+template <typename T, typename Device>
+struct DLPackContext {
+    DLManagedTensor managed;
+    Tensor<T, Device> tensor;
+    std::vector<int64_t> shape;
+    std::vector<int64_t> strides;
+};
+
+} // namespace detail
+
+/**
+ * @brief Exports `t` as a DLPack tensor sharing its storage. The consumer
+ *        takes ownership and must call `deleter` on the result when done.
+ */
+template <typename T, typename Device>
+DLManagedTensor *to_dlpack(Tensor<T, Device> const &t) {
+    auto context = new detail::DLPackContext<T, Device>{
+        {}, t,
+        std::vector<int64_t>(t.shape().begin(), t.shape().end()),
+        std::vector<int64_t>(t.strides().begin(), t.strides().end())
+    };
+
+    auto &dl_tensor = context->managed.dl_tensor;
+    dl_tensor.data = context->tensor.data();
+    dl_tensor.device = {dlpack_device<Device>::type, 0};
+    dl_tensor.ndim = int32_t(t.num_dims());
+    dl_tensor.dtype = dlpack_dtype<T>();
+    dl_tensor.shape = context->shape.data();
+    dl_tensor.strides = context->strides.data();
+    dl_tensor.byte_offset = 0;
+
+    context->managed.manager_ctx = context;
+    context->managed.deleter = [](DLManagedTensor *self) {
+        delete static_cast<detail::DLPackContext<T, Device> *>(self->manager_ctx);
+    };
+
+    return &context->managed;
+}
+
+/**
+ * @brief Imports a DLPack tensor without copying. The returned Tensor takes
+ *        ownership of `managed` and calls its deleter once the last Tensor
+ *        sharing the storage is gone.
+ *
+ * Throws `UnsupportedDLPackTensor` (leaving `managed` with the caller) if the
+ * tensor is not in host memory, its element type is not `T`, or it has
+ * negative strides.
+ */
+template <typename T, typename Device=CPU>
+Tensor<T, Device> from_dlpack(DLManagedTensor *managed) {
+    auto const &dl_tensor = managed->dl_tensor;
+
+    if (dl_tensor.device.device_type != kDLCPU && dl_tensor.device.device_type != kDLCUDAHost) {
+        throw UnsupportedDLPackTensor(fmt::format("device type {} is not host memory",
+                                                  int(dl_tensor.device.device_type)));
+    }
+
+    auto dtype = dlpack_dtype<T>();
+    if (dl_tensor.dtype.code != dtype.code || dl_tensor.dtype.bits != dtype.bits ||
+        dl_tensor.dtype.lanes != dtype.lanes)
+    {
+        throw UnsupportedDLPackTensor("element type does not match");
+    }
+
+    extent shape(dl_tensor.shape, dl_tensor.shape + dl_tensor.ndim);
+
+    // null strides mean a compact row-major tensor
+    indices strides;
+    if (dl_tensor.strides) {
+        for (int32_t d = 0; d < dl_tensor.ndim; d++) {
+            if (dl_tensor.strides[d] < 0) throw UnsupportedDLPackTensor("negative strides");
+            strides.push_back(index_t(dl_tensor.strides[d]));
+        }
+    } else {
+        strides = make_strides(shape, make_row_major_order(shape.size()));
+    }
+
+    auto data = reinterpret_cast<T *>(static_cast<char *>(dl_tensor.data) + dl_tensor.byte_offset);
+    return from_buffer<T, Device>(data, shape, strides, [managed](T *) {
+        if (managed->deleter) managed->deleter(managed);
+    });
+}
+
+#endif
@@ -0,0 +1,134 @@
+#ifndef EXPRESSION_HPP
+#define EXPRESSION_HPP
+
+#include <array>
+#include <type_traits>
+#include <vector>
+
+#include "types.hpp"
+
+template <typename T, typename Device>
+class Tensor;
+
+template <typename Op, typename L, typename R>
+class BinaryExpression;
+
+/**
+ * @brief True for lazily evaluated elementwise expressions
+ */
+template <typename E>
+struct is_expression: std::false_type {};
+
+template <typename Op, typename L, typename R>
+struct is_expression<BinaryExpression<Op, L, R>>: std::true_type {};
+
+template <typename E>
+constexpr bool is_expression_v = is_expression<E>::value;
+
+/**
+ * @brief True for anything that can appear in an elementwise expression
+ *        (a `Tensor` or another expression)
+ */
+template <typename E>
+struct is_operand: is_expression<E> {};
+
+template <typename T, typename Device>
+struct is_operand<Tensor<T, Device>>: std::true_type {};
+
+template <typename E>
+constexpr bool is_operand_v = is_operand<E>::value;
+
+/**
+ * @brief Leaf of an expression tree. Holds its `Tensor` by value (sharing
+ *        storage), so expressions may outlive the tensors they were built from.
+ *
+ * Leaves are numbered left to right; at evaluation time leaf `I` reads from
+ * `data[I]`, which already points at the element for the current index.
+ */
+template <typename T, typename D>
+class TensorOperand {
+public:
+    using NumericType = T;
+    using Device = D;
+
+    static constexpr std::size_t leaves = 1;
+
+    explicit TensorOperand(Tensor<T, Device> const &tensor): tensor_(tensor) {}
+
+    extent const &shape() const { return tensor_.shape(); }
+
+    void collect(std::vector<Tensor<T, Device>> &operands) const {
+        operands.push_back(tensor_);
+    }
+
+    template <std::size_t I, std::size_t N>
+    T at(std::array<T const *, N> const &data, index_t i) const {
+        return data[I][i];
+    }
+
+    template <std::size_t I, std::size_t N>
+    T at(std::array<T const *, N> const &data,
+         std::array<index_t, N> const &strides,
+         index_t i) const
+    {
+        return data[I][i*strides[I]];
+    }
+private:
+    Tensor<T, Device> tensor_;
+};
+
+/**
+ * @brief Elementwise `Op` applied to two sub-expressions. Nothing is computed
+ *        until the expression is assigned to a `Tensor` or passed to `eval()`,
+ *        at which point the whole tree is evaluated in a single pass.
+ *
+ * @tparam Op Binary function object (e.g. `std::plus<>`)
+ * @tparam L Left operand (`TensorOperand` or expression)
+ * @tparam R Right operand (`TensorOperand` or expression)
+ */
+template <typename Op, typename L, typename R>
+class BinaryExpression {
+public:
+    using NumericType = typename L::NumericType;
+    using Device = typename L::Device;
+
+    static constexpr std::size_t leaves = L::leaves + R::leaves;
+
+    /**
+     * @param shape The broadcast shape of `lhs` and `rhs`
+     */
+    BinaryExpression(L const &lhs, R const &rhs, extent const &shape):
+        lhs_(lhs), rhs_(rhs), shape_(shape) {}
+
+    extent const &shape() const { return shape_; }
+    std::size_t num_dims() const { return shape_.size(); }
+
+    /**
+     * @brief Appends the tensor held by each leaf, left to right
+     */
+    void collect(std::vector<Tensor<NumericType, Device>> &operands) const {
+        lhs_.collect(operands);
+        rhs_.collect(operands);
+    }
+
+    template <std::size_t I, std::size_t N>
+    NumericType at(std::array<NumericType const *, N> const &data, index_t i) const {
+        return Op{}(lhs_.template at<I>(data, i),
+                    rhs_.template at<I + L::leaves>(data, i));
+    }
+
+    template <std::size_t I, std::size_t N>
+    NumericType at(std::array<NumericType const *, N> const &data,
+                   std::array<index_t, N> const &strides,
+                   index_t i) const
+    {
+        return Op{}(lhs_.template at<I>(data, strides, i),
+                    rhs_.template at<I + L::leaves>(data, strides, i));
+    }
+private:
+    L lhs_;
+    R rhs_;
+    extent shape_;
+};
+
+#endif
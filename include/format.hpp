@@ -1,66 +1,157 @@
 #ifndef FORMAT_HPP
 #define FORMAT_HPP
 
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <type_traits>
+
 #include <fmt/format.h>
 
-template <typename OutputIterator>
-void repeat(OutputIterator write, const char ch, std::size_t count) {
+/**
+ * @brief Controls how tensors are formatted (see `format_options()`)
+ */
+struct FormatOptions {
+    // tensors with more elements than this are summarized
+    std::size_t threshold = 1000;
+
+    // number of items shown at each end of a summarized dimension
+    index_t edge_items = 3;
+
+    // digits after the decimal point for floating point elements; negative
+    // uses the shortest representation
+    int precision = -1;
+};
+
+/**
+ * @brief Options used when formatting tensors. Like NumPy, a tensor with
+ *        more than `threshold` elements is summarized: dimensions longer than
+ *        `2*edge_items` only show their first and last `edge_items` entries,
+ *        with `...` in between.
+ */
+inline FormatOptions &format_options() {
+    static FormatOptions options;
+    return options;
+}
+
+namespace detail {
+
+template <typename Buffer>
+void append(Buffer &buffer, char const *text) {
+    buffer.append(text, text + std::strlen(text));
+}
+
+template <typename Buffer>
+void repeat(Buffer &buffer, const char ch, std::size_t count) {
     for (std::size_t i = 0; i < count; i++) {
-        fmt::format_to(write, "{}", ch);
+        buffer.push_back(ch);
     }
 }
 
-// displays the inner most dimension as a row of values
-template <typename OutputIterator, typename Sliceable>
-void format_inner(OutputIterator write, Sliceable const &slice) {
-    index_t last_dim_size = slice.shape(slice.num_dims()-1);
+template <typename Buffer, typename T>
+void format_element(Buffer &buffer, T const &value, FormatOptions const &options) {
+    auto out = std::back_inserter(buffer);
 
-    fmt::format_to(write, "[");
-    for (index_t i = 0; i < last_dim_size; i++) {
-        auto offset = calculate_offset(slice.view(), i);
+    if constexpr (std::is_floating_point_v<T>) {
+        if (options.precision >= 0) {
+            fmt::format_to(out, "{:3.{}f}", value, options.precision);
+            return;
+        }
+    }
 
-        fmt::format_to(write, "{:3}", slice.storage()[offset]);
+    fmt::format_to(out, "{:3}", value);
+}
 
-        if (i < last_dim_size-1) {
-            fmt::format_to(write, ", ");
-        }
+// calls `fn(i)` for each index of a dimension of `size` that is shown, and
+// `fn(size)` where the elided entries go
+template <typename F>
+void for_each_shown(index_t size, bool summarize, index_t edge_items, F fn) {
+    if (!summarize || size <= 2*edge_items) {
+        for (index_t i = 0; i < size; i++) fn(i);
+        return;
     }
 
-    fmt::format_to(write, "]");
+    for (index_t i = 0; i < edge_items; i++) fn(i);
+    fn(size);
+    for (index_t i = size - edge_items; i < size; i++) fn(i);
 }
 
-template <typename OutputIterator, typename Sliceable>
-void format_outer(OutputIterator write, Sliceable const &slice, index_t index) {
-    for (index_t i = 0; i < slice.shape(index); i++) {
-        if (i == 0) {
-            fmt::format_to(write, "[");
+// displays the inner most dimension as a row of values
+template <typename Buffer, typename T>
+void format_inner(Buffer &buffer, T const *data, index_t size, index_t stride,
+                  bool summarize, FormatOptions const &options)
+{
+    buffer.push_back('[');
+    for_each_shown(size, summarize, options.edge_items, [&](index_t i) {
+        if (i == size) {
+            append(buffer, "...");
         } else {
-            repeat(write, ' ', index+1);
+            format_element(buffer, data[i*stride], options);
         }
 
-        auto next_slice = slice[i];
-        if (next_slice.index() == next_slice.num_dims()-2) {
-            format_inner(write, next_slice);
+        if (i != size - 1) append(buffer, ", ");
+    });
+    buffer.push_back(']');
+}
+
+template <typename Buffer, typename T>
+void format_outer(Buffer &buffer, T const *data, extent const &shape, indices const &strides,
+                  index_t dim, bool summarize, FormatOptions const &options)
+{
+    auto dims = shape.size();
+    if (dim == dims - 1) {
+        format_inner(buffer, data, shape[dim], strides[dim], summarize, options);
+        return;
+    }
+
+    if (shape[dim] == 0) {
+        append(buffer, "[]");
+        return;
+    }
+
+    bool first = true;
+    for_each_shown(shape[dim], summarize, options.edge_items, [&](index_t i) {
+        if (first) {
+            buffer.push_back('[');
+            first = false;
         } else {
-            format_outer(write, next_slice, next_slice.index()+1);
+            repeat(buffer, ' ', dim+1);
         }
 
-        if (i == slice.shape(index)-1) {
-            fmt::format_to(write, "]");
+        if (i == shape[dim]) {
+            append(buffer, "...");
         } else {
-            fmt::format_to(write, ",");
-            repeat(write, '\n', (slice.num_dims() - index)-1);
+            format_outer(buffer, data + i*strides[dim], shape, strides, dim+1, summarize, options);
         }
-    }
+
+        if (i == shape[dim]-1) {
+            buffer.push_back(']');
+        } else {
+            buffer.push_back(',');
+            repeat(buffer, '\n', dims - dim - 1);
+        }
+    });
 }
 
+} // namespace detail
+
+/**
+ * @brief Writes `tensor` to `write`. The text is built in a local buffer by
+ *        walking the tensor's strides, then written out in one piece.
+ */
 template <typename OutputIterator, typename T, typename Device>
-void format_tensor(OutputIterator write, Tensor<T, Device> const &tensor) {
-    if (tensor.num_dims() > 1) {
-        format_outer(write, tensor, 0);
-    } else {
-        format_inner(write, tensor);
+OutputIterator format_tensor(OutputIterator write, Tensor<T, Device> const &tensor,
+                             FormatOptions const &options=format_options())
+{
+    fmt::memory_buffer buffer;
+
+    if (tensor.num_dims() > 0) {
+        bool summarize = num_elements(tensor.shape()) > options.threshold;
+        detail::format_outer(buffer, tensor.data(), tensor.shape(), tensor.strides(), 0,
+                             summarize, options);
     }
+
+    return std::copy(buffer.begin(), buffer.end(), write);
 }
 
 namespace fmt {
@@ -74,8 +165,20 @@ struct formatter<Tensor<T, Device>> {
 
     template <typename FormatContext>
     auto format(const Tensor<T, Device> &t, FormatContext &ctx) {
-        format_tensor(ctx.out(), t);
-        return ctx.out();
+        return format_tensor(ctx.out(), t);
+    }
+};
+
+template <typename Op, typename L, typename R>
+struct formatter<BinaryExpression<Op, L, R>> {
+    template <typename ParseContext>
+    constexpr auto parse(ParseContext &ctx) {
+        return ctx.begin();
+    }
+
+    template <typename FormatContext>
+    auto format(const BinaryExpression<Op, L, R> &e, FormatContext &ctx) {
+        return format_tensor(ctx.out(), eval(e));
     }
 };
 
@@ -0,0 +1,262 @@
+#ifndef GEMM_HPP
+#define GEMM_HPP
+
+#include <algorithm>
+#include <vector>
+
+#include "simd.hpp"
+#include "types.hpp"
+#include "thread_pool.hpp"
+
+/**
+ * @brief Block sizes used by `gemm` for element type `T`.
+ *
+ * A `kc x nr` panel of B is sized to stay in L1, an `mc x kc` block of A in
+ * L2 and a `kc x nc` block of B in L3. The `mr x nr` tile of C accumulated by
+ * the micro-kernel spans one cache line of B per row, which the compiler
+ * keeps in vector registers.
+ */
+template <typename T>
+struct GemmBlocking {
+    static constexpr index_t nr = std::min<index_t>(16, std::max<index_t>(4, 64/sizeof(T)));
+    static constexpr index_t mr = 6;
+    static constexpr index_t kc = 256;
+    static constexpr index_t mc = mr*12;
+    static constexpr index_t nc = nr*256;
+
+    // products of at most this many multiply-adds skip packing entirely
+    static constexpr index_t small = 8*8*8;
+};
+
+/**
+ * @brief Strided matrix operand: element `(i, j)` is at
+ *        `data[i*row_stride + j*col_stride]`
+ */
+template <typename T>
+struct MatrixRef {
+    T *data;
+    index_t row_stride;
+    index_t col_stride;
+};
+
+namespace detail {
+
+// copies rows [0, mc) x columns [0, kc) of `a` into panels of `mr` rows,
+// each stored column by column and zero-padded to a full panel
+template <typename T, index_t MR>
+void pack_a(MatrixRef<T const> a, index_t mc, index_t kc, T *packed) {
+    for (index_t ir = 0; ir < mc; ir += MR) {
+        index_t mr = std::min(MR, mc - ir);
+
+        for (index_t p = 0; p < kc; p++) {
+            T const *column = a.data + ir*a.row_stride + p*a.col_stride;
+
+            for (index_t i = 0; i < mr; i++) {
+                *packed++ = column[i*a.row_stride];
+            }
+
+            for (index_t i = mr; i < MR; i++) {
+                *packed++ = T(0);
+            }
+        }
+    }
+}
+
+// copies rows [0, kc) x columns [0, nc) of `b` into panels of `nr` columns,
+// each stored row by row and zero-padded to a full panel
+template <typename T, index_t NR>
+void pack_b(MatrixRef<T const> b, index_t kc, index_t nc, T *packed) {
+    for (index_t jr = 0; jr < nc; jr += NR) {
+        index_t nr = std::min(NR, nc - jr);
+
+        for (index_t p = 0; p < kc; p++) {
+            T const *row = b.data + p*b.row_stride + jr*b.col_stride;
+
+            if (b.col_stride == 1) {
+                std::copy_n(row, nr, packed);
+                packed += nr;
+            } else {
+                for (index_t j = 0; j < nr; j++) {
+                    *packed++ = row[j*b.col_stride];
+                }
+            }
+
+            for (index_t j = nr; j < NR; j++) {
+                *packed++ = T(0);
+            }
+        }
+    }
+}
+
+// adds the product of an `MR x kc` panel of A and a `kc x NR` panel of B to
+// the `mr x nr` tile of C (mr <= MR, nr <= NR)
+template <typename T, index_t MR, index_t NR>
+void gemm_micro_kernel(index_t kc, T const *a, T const *b, MatrixRef<T> c,
+                       index_t mr, index_t nr)
+{
+    T acc[MR][NR] = {};
+
+    for (index_t p = 0; p < kc; p++) {
+        // unrolled so each row of `acc` is a vector kept in registers; left
+        // to itself, GCC at -O3 vectorizes over `p` and spills `acc` instead
+        #pragma GCC unroll 16
+        for (index_t i = 0; i < MR; i++) {
+            for (index_t j = 0; j < NR; j++) {
+                acc[i][j] += a[i]*b[j];
+            }
+        }
+
+        a += MR;
+        b += NR;
+    }
+
+    for (index_t i = 0; i < mr; i++) {
+        T *row = c.data + i*c.row_stride;
+        for (index_t j = 0; j < nr; j++) {
+            row[j*c.col_stride] += acc[i][j];
+        }
+    }
+}
+
+// unpacked `C += A*B`, for products too small to amortize packing
+template <typename T>
+void gemm_small(index_t m, index_t n, index_t k,
+                MatrixRef<T const> a, MatrixRef<T const> b, MatrixRef<T> c)
+{
+    for (index_t i = 0; i < m; i++) {
+        T *c_row = c.data + i*c.row_stride;
+
+        for (index_t p = 0; p < k; p++) {
+            T a_ip = a.data[i*a.row_stride + p*a.col_stride];
+            T const *b_row = b.data + p*b.row_stride;
+
+            if (b.col_stride == 1 && c.col_stride == 1) {
+                for (index_t j = 0; j < n; j++) {
+                    c_row[j] += a_ip*b_row[j];
+                }
+            } else {
+                for (index_t j = 0; j < n; j++) {
+                    c_row[j*c.col_stride] += a_ip*b_row[j*b.col_stride];
+                }
+            }
+        }
+    }
+}
+
+inline index_t round_up(index_t value, index_t multiple) {
+    return (value + multiple - 1)/multiple*multiple;
+}
+
+} // namespace detail
+
+/**
+ * @brief Computes `C += A*B` for an `m x k` matrix A and a `k x n` matrix B.
+ *
+ * All three operands may have arbitrary strides, so transposed or sliced
+ * operands are read in place. A and B are packed into contiguous panels one
+ * cache block at a time, and blocks of rows of C are computed in parallel.
+ */
+template <typename T>
+void gemm(index_t m, index_t n, index_t k,
+          MatrixRef<T const> a, MatrixRef<T const> b, MatrixRef<T> c)
+{
+    using Blocking = GemmBlocking<T>;
+    constexpr index_t MR = Blocking::mr;
+    constexpr index_t NR = Blocking::nr;
+
+    if (m == 0 || n == 0 || k == 0) return;
+
+    if (m*n*k <= Blocking::small) {
+        simd_dispatch([&] { detail::gemm_small(m, n, k, a, b, c); });
+        return;
+    }
+
+    // buffers are sized for the blocks actually used, so small products
+    // don't pay for full-size panels
+    std::vector<T> packed_b(std::min(Blocking::kc, k)*detail::round_up(std::min(Blocking::nc, n), NR));
+
+    for (index_t jc = 0; jc < n; jc += Blocking::nc) {
+        index_t nc = std::min(Blocking::nc, n - jc);
+
+        for (index_t pc = 0; pc < k; pc += Blocking::kc) {
+            index_t kc = std::min(Blocking::kc, k - pc);
+
+            MatrixRef<T const> b_block{b.data + pc*b.row_stride + jc*b.col_stride,
+                                       b.row_stride, b.col_stride};
+            simd_dispatch([&] { detail::pack_b<T, NR>(b_block, kc, nc, packed_b.data()); });
+
+            index_t num_blocks = (m + Blocking::mc - 1)/Blocking::mc;
+            index_t block_work = Blocking::mc*kc*nc;
+
+            parallel_for(0, num_blocks, grain_size_for(block_work), [&](index_t begin, index_t end) {
+                std::vector<T> packed_a(std::min(Blocking::mc, detail::round_up(m, MR))*kc);
+
+                // packing and the micro-kernel are compiled for each SIMD level
+                simd_dispatch([&] {
+                    for (index_t block = begin; block < end; block++) {
+                        index_t ic = block*Blocking::mc;
+                        index_t mc = std::min(Blocking::mc, m - ic);
+
+                        MatrixRef<T const> a_block{a.data + ic*a.row_stride + pc*a.col_stride,
+                                                   a.row_stride, a.col_stride};
+                        detail::pack_a<T, MR>(a_block, mc, kc, packed_a.data());
+
+                        for (index_t jr = 0; jr < nc; jr += NR) {
+                            for (index_t ir = 0; ir < mc; ir += MR) {
+                                MatrixRef<T> c_tile{
+                                    c.data + (ic + ir)*c.row_stride + (jc + jr)*c.col_stride,
+                                    c.row_stride, c.col_stride};
+
+                                detail::gemm_micro_kernel<T, MR, NR>(
+                                    kc, packed_a.data() + ir*kc, packed_b.data() + jr*kc,
+                                    c_tile, std::min(MR, mc - ir), std::min(NR, nc - jr));
+                            }
+                        }
+                    }
+                });
+            });
+        }
+    }
+}
+
+/**
+ * @brief Computes `y += A*x` for an `m x n` matrix A, where `x` has `n`
+ *        elements spaced `x_stride` apart and `y` has `m` elements spaced
+ *        `y_stride` apart. Rows of A are split across the thread pool.
+ */
+template <typename T>
+void gemv(index_t m, index_t n, MatrixRef<T const> a,
+          T const *x, index_t x_stride, T *y, index_t y_stride)
+{
+    parallel_for(0, m, grain_size_for(n), [&](index_t begin, index_t end) {
+        simd_dispatch([&] {
+            for (index_t i = begin; i < end; i++) {
+                T const *row = a.data + i*a.row_stride;
+
+                T sum(0);
+                for (index_t j = 0; j < n; j++) {
+                    sum += row[j*a.col_stride]*x[j*x_stride];
+                }
+
+                y[i*y_stride] += sum;
+            }
+        });
+    });
+}
+
+/**
+ * @brief Returns the dot product of two strided vectors of `n` elements
+ */
+template <typename T>
+T dot(index_t n, T const *x, index_t x_stride, T const *y, index_t y_stride) {
+    T sum(0);
+    simd_dispatch([&] {
+        for (index_t i = 0; i < n; i++) {
+            sum += x[i*x_stride]*y[i*y_stride];
+        }
+    });
+
+    return sum;
+}
+
+#endif
@@ -2,12 +2,21 @@
 #define INDEX_GENERATOR_HPP
 
 #include <algorithm>
+#include <array>
 #include <numeric>
 #include <range/v3/all.hpp>
 
 #include "types.hpp"
 #include "layout.hpp"
 
+/**
+ * @brief Generates every index of a shape, odometer style.
+ *
+ * Each call to `next()` bumps the fastest moving dimension and carries into
+ * the slower ones, so no division or modulo is done per element. Any number
+ * of layouts can be tracked alongside the index; their storage offsets are
+ * updated incrementally and are available through `offset(i)`.
+ */
 class index_generator: public ranges::view_facade<index_generator, ranges::finite> {
 public:
     friend ranges::range_access;
@@ -16,7 +25,7 @@ public:
 
     index_generator(extent const &shape, indices const &strides):
         shape_(shape),
-        strides_(strides),
+        order_(stride_order(strides)),
         index_(shape.size(), 0),
         count_(0),
         max_count_(::num_elements(shape_)) {}
@@ -25,37 +34,136 @@ public:
         index_generator(shape, make_strides(shape, make_row_major_order(shape.size()))) {}
 
     explicit index_generator(Layout const &layout):
-        index_generator(layout.shape, layout.strides) {}
-
-    explicit index_generator(View const &view):
-        index_generator(view.shape, make_strides(view.shape, view.order)) {}
-private:
-    void update_index(index_t value) {
-        auto write = std::begin(index_);
-        auto extent = std::begin(shape_);
+        index_generator(layout.shape, layout.strides)
+    {
+        track(layout.strides, 0);
+    }
 
-        for (auto const &stride : strides_) {
-            *write++ = index_t(value / stride) % *extent++;
-        }
+    /**
+     * @brief Iterates over `view` in its own order, tracking the storage
+     *        offset of `view` (`offset(0)`) and of each of `views`
+     *        (`offset(1)`, ...). All views must have the same shape.
+     */
+    template <typename... Views>
+    explicit index_generator(View const &view, Views const &... views):
+        shape_(view.shape),
+        order_(view.order),
+        index_(view.shape.size(), 0),
+        count_(0),
+        max_count_(::num_elements(shape_))
+    {
+        track(view);
+        (track(views), ...);
     }
-public:
+
     void next() {
-        ++count_;
-        update_index(count_);
-    }
+        if (++count_ == max_count_) return;
 
-    bool equal(ranges::default_sentinel_t) const {
-        return count_ == max_count_;
+        for (auto dim : order_) {
+            if (++index_[dim] < shape_[dim]) {
+                for (std::size_t i = 0; i < offsets_.size(); i++) {
+                    offsets_[i] += tracked_strides_[i][dim];
+                }
+                return;
+            }
+
+            // carry into the next slowest dimension
+            index_[dim] = 0;
+            for (std::size_t i = 0; i < offsets_.size(); i++) {
+                offsets_[i] -= (shape_[dim]-1)*tracked_strides_[i][dim];
+            }
+        }
     }
 
+    bool done() const { return count_ == max_count_; }
+
+    bool equal(ranges::default_sentinel_t) const { return done(); }
+
     const extent &read() const { return index_; }
+
+    /**
+     * @brief Storage offset of the current index in the `i`th tracked layout
+     */
+    offset_t offset(std::size_t i=0) const { return offsets_[i]; }
 private:
+    void track(indices const &strides, offset_t base) {
+        tracked_strides_.push_back(strides);
+        offsets_.push_back(base);
+    }
+
+    void track(View const &view) {
+        track(view.strides, base_offset(view));
+    }
+
     extent shape_;
-    indices strides_;
+
+    // dimensions from fastest to slowest moving
+    indices order_;
     indices index_;
 
+    std::vector<indices> tracked_strides_;
+    std::vector<offset_t> offsets_;
+
     index_t count_;
     index_t max_count_;
 };
 
-#endif
\ No newline at end of file
+/**
+ * @brief Returns the number of innermost runs in `loop`
+ */
+inline index_t num_spans(LoopLayout const &loop) {
+    return ::num_elements(loop.shape) / loop.shape[0];
+}
+
+/**
+ * @brief Calls `fn(offsets, length)` for the innermost runs `begin` to `end`
+ *        of `loop`, where `offsets[i]` is the storage offset of the run's
+ *        first element in the `i`th operand and `length` is `loop.shape[0]`.
+ *        `offsets` holds the base offset of each operand on entry.
+ */
+template <std::size_t N, typename F>
+void for_each_span(LoopLayout const &loop, std::array<offset_t, N> offsets,
+                   index_t begin, index_t end, F fn)
+{
+    std::size_t dims = loop.shape.size();
+    indices index(dims, 0);
+
+    // position on the first run; only done once per call
+    index_t remaining = begin;
+    for (std::size_t d = 1; d < dims; d++) {
+        index[d] = remaining % loop.shape[d];
+        remaining /= loop.shape[d];
+
+        for (std::size_t i = 0; i < N; i++) {
+            offsets[i] += index[d]*loop.strides[i][d];
+        }
+    }
+
+    for (index_t span = begin; span < end; span++) {
+        fn(offsets, loop.shape[0]);
+
+        for (std::size_t d = 1; d < dims; d++) {
+            if (++index[d] < loop.shape[d]) {
+                for (std::size_t i = 0; i < N; i++) {
+                    offsets[i] += loop.strides[i][d];
+                }
+                break;
+            }
+
+            index[d] = 0;
+            for (std::size_t i = 0; i < N; i++) {
+                offsets[i] -= (loop.shape[d]-1)*loop.strides[i][d];
+            }
+        }
+    }
+}
+
+/**
+ * @brief Calls `fn(offsets, length)` for every innermost run of `loop`
+ */
+template <std::size_t N, typename F>
+void for_each_span(LoopLayout const &loop, std::array<offset_t, N> offsets, F fn) {
+    for_each_span<N>(loop, offsets, 0, num_spans(loop), fn);
+}
+
+#endif
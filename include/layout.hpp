@@ -1,6 +1,10 @@
 #ifndef LAYOUT_HPP
 #define LAYOUT_HPP
 
+#include <algorithm>
+#include <numeric>
+#include <utility>
+
 #include "types.hpp"
 #include "stride_generator.hpp"
 
@@ -10,6 +14,10 @@ struct Layout {
     Layout(Layout const &layout):
         shape(layout.shape), strides(layout.strides) {}
 
+    Layout(Layout &&layout) = default;
+    Layout &operator =(Layout const &layout) = default;
+    Layout &operator =(Layout &&layout) = default;
+
     Layout(extent const &shape, indices const &strides):
         shape(shape), strides(strides) {}
 
@@ -29,7 +37,8 @@ inline indices make_offset(std::size_t dims) {
 }
 
 inline indices increasing_order(std::size_t num_dims) {
-    indices result = ranges::view::iota(0) | ranges::view::take(num_dims);
+    indices result(num_dims);
+    std::iota(result.begin(), result.end(), 0);
     return result;
 }
 
@@ -42,7 +51,8 @@ struct View: public Layout {
          indices const &strides):
         Layout(shape, strides),
         offset(offset),
-        order(order) {}
+        order(order),
+        base(fold_offset(offset, strides)) {}
 
     View(extent const &shape,
          indices const &order,
@@ -59,14 +69,16 @@ struct View: public Layout {
          indices const &order):
         Layout(shape, layout.strides),
         offset(offset),
-        order(order) {}
+        order(order),
+        base(fold_offset(offset, layout.strides)) {}
 
     View(Layout const &layout,
          extent const &shape,
          indices const &offset):
         Layout(shape, layout.strides),
         offset(offset),
-        order(increasing_order(shape.size())) {}
+        order(increasing_order(shape.size())),
+        base(fold_offset(offset, layout.strides)) {}
 
     View(Layout const &layout,
          extent const &shape):
@@ -78,25 +90,43 @@ struct View: public Layout {
              increasing_order(layout.shape.size())) {}
 
     explicit View(View const &view):
-        Layout(view), offset(view.offset), order(view.order) {}
+        Layout(view), offset(view.offset), order(view.order), base(view.base) {}
 
-    offset_t get_offset(index_t dim, index_t index) const {
-        return (index+offset[dim])*strides[dim];
-    }
+    View(View &&view) = default;
+    View &operator =(View const &view) = default;
+    View &operator =(View &&view) = default;
 
+    // where each dimension starts relative to the storage this view was
+    // taken from; kept for introspection, addressing only uses `base`
     indices offset;
     indices order;
+
+    // storage offset of index (0, ..., 0), so index `i` is at
+    // `base + sum(i[d]*strides[d])`. Slicing, transposing, reshaping and
+    // broadcasting carry it over rather than recomputing it from `offset`.
+    offset_t base = 0;
+private:
+    static offset_t fold_offset(indices const &offset, indices const &strides) {
+        offset_t result = 0;
+        for (std::size_t d = 0; d < offset.size(); d++) result += offset[d]*strides[d];
+        return result;
+    }
 };
 
 inline std::size_t num_dims(Layout const &layout) { return layout.size(); }
 inline std::size_t num_dims(View const &view) { return view.size(); }
 
+/**
+ * @brief Returns the storage offset of the first element of `view`
+ */
+inline offset_t base_offset(View const &view) { return view.base; }
+inline offset_t base_offset(Layout const &) { return 0; }
 
 template <typename LayoutType, typename ContainerType>
 offset_t calculate_offset(const LayoutType &layout,
                           ContainerType const &index)
 {
-    offset_t offset = 0;
+    offset_t offset = base_offset(layout);
 
     for (std::size_t d = 0; d < num_dims(layout); d++) {
         offset += layout.get_offset(d, index[d]);
@@ -105,17 +135,121 @@ offset_t calculate_offset(const LayoutType &layout,
     return offset;
 }
 
+namespace detail {
+
+template <std::size_t... D, typename... Args>
+offset_t unrolled_offset(View const &view, std::index_sequence<D...>, Args... index) {
+    return view.base + ((static_cast<index_t>(index)*view.strides[D]) + ... + 0);
+}
+
+} // namespace detail
+
+/**
+ * @brief Storage offset of `index...` in `view`, as a single sum of
+ *        `index*stride` terms. Takes one index per dimension, unchecked.
+ */
+template <typename... Args>
+offset_t unrolled_offset(View const &view, Args... index) {
+    return detail::unrolled_offset(view, std::index_sequence_for<Args...>{}, index...);
+}
+
+/**
+ * @brief Returns true if iterating `view` in its own order walks storage one
+ *        element at a time. Singleton dimensions are ignored.
+ */
+inline bool is_contiguous(View const &view) {
+    auto dense_strides = make_strides(view.shape, view.order);
+
+    for (index_t d = 0; d < num_dims(view); d++) {
+        if (view.shape[d] > 1 && view.strides[d] != dense_strides[d]) return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Returns true if `lhs` and `rhs` (which must have the same shape) place
+ *        each index at the same relative storage offset
+ */
+inline bool same_strides(Layout const &lhs, Layout const &rhs) {
+    for (index_t d = 0; d < num_dims(lhs); d++) {
+        if (lhs.shape[d] > 1 && lhs.strides[d] != rhs.strides[d]) return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Returns the dimensions sorted from smallest to largest stride
+ */
+inline indices stride_order(indices const &strides) {
+    indices order(strides.size());
+    std::iota(std::begin(order), std::end(order), 0);
+    std::stable_sort(std::begin(order), std::end(order),
+        [&strides](index_t lhs, index_t rhs) { return strides[lhs] < strides[rhs]; });
+    return order;
+}
+
+/**
+ * @brief Shape and per-operand strides of an elementwise loop, with the
+ *        dimensions ordered from fastest to slowest moving
+ */
+struct LoopLayout {
+    extent shape;
+
+    // strides[operand][dim]
+    std::vector<indices> strides;
+};
+
+/**
+ * @brief Normalizes the loop over `shape` shared by operands with the given
+ *        `strides`: dimensions are visited in `order` (fastest first),
+ *        singleton dimensions are dropped, and neighbouring dimensions are
+ *        merged whenever every operand steps over them as a single dimension.
+ *        Always returns at least one dimension.
+ */
+inline LoopLayout coalesce(extent const &shape,
+                           indices const &order,
+                           std::vector<indices> const &strides)
+{
+    LoopLayout result;
+    result.strides.resize(strides.size());
+
+    for (auto dim : order) {
+        if (shape[dim] == 1) continue;
+
+        bool mergeable = !result.shape.empty();
+        for (std::size_t i = 0; mergeable && i < strides.size(); i++) {
+            mergeable = strides[i][dim] == result.strides[i].back()*result.shape.back();
+        }
+
+        if (mergeable) {
+            result.shape.back() *= shape[dim];
+        } else {
+            result.shape.push_back(shape[dim]);
+            for (std::size_t i = 0; i < strides.size(); i++) {
+                result.strides[i].push_back(strides[i][dim]);
+            }
+        }
+    }
+
+    if (result.shape.empty()) {
+        result.shape.push_back(1);
+        for (auto &operand_strides : result.strides) {
+            operand_strides.push_back(0);
+        }
+    }
+
+    return result;
+}
+
 // TODO: provide check that all but one dimension is a singleton
 template <typename LayoutType>
 offset_t calculate_offset(const LayoutType &layout, index_t index) {
-    offset_t offset = 0;
+    offset_t offset = base_offset(layout);
 
     for (index_t i = 0; i < layout.size(); i++) {
-        if (layout.shape[i] == 1) {
-            offset += layout.get_offset(i, 0);
-        } else {
-            offset += layout.get_offset(i, index);
-        }
+        if (layout.shape[i] != 1) offset += layout.get_offset(i, index);
     }
 
     return offset;
@@ -0,0 +1,183 @@
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#include <cerrno>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "tensor.hpp"
+
+/**
+ * @brief How a file is mapped into memory
+ */
+enum class MapMode {
+    // pages may only be read; writing to them faults
+    ReadOnly,
+
+    // writes go through to the file
+    ReadWrite,
+
+    // writes are private to the mapping and never reach the file
+    CopyOnWrite
+};
+
+/**
+ * @brief Expected access pattern, passed to the kernel as an `madvise` hint
+ */
+enum class MapAccess {
+    Normal,
+
+    // read ahead aggressively and drop pages soon after they are read
+    Sequential,
+
+    // don't read ahead
+    Random,
+
+    // start reading the whole range in now
+    WillNeed
+};
+
+/**
+ * @brief A file mapped into memory. Pages are read from the file as they are
+ *        first touched, so files larger than RAM can be mapped.
+ */
+class MappedFile {
+public:
+    MappedFile(std::string const &path, MapMode mode=MapMode::ReadOnly,
+               MapAccess access=MapAccess::Normal):
+        mode_(mode)
+    {
+        int fd = ::open(path.c_str(), mode == MapMode::ReadWrite ? O_RDWR : O_RDONLY);
+        if (fd < 0) throw_error("Cannot open " + path);
+
+        struct stat info;
+        if (::fstat(fd, &info) != 0) {
+            ::close(fd);
+            throw_error("Cannot stat " + path);
+        }
+
+        size_ = std::size_t(info.st_size);
+
+        // mmap rejects empty ranges; an empty file maps to nothing
+        if (size_ > 0) {
+            int protection = mode == MapMode::ReadOnly ? PROT_READ : PROT_READ | PROT_WRITE;
+            int flags = mode == MapMode::CopyOnWrite ? MAP_PRIVATE : MAP_SHARED;
+
+            void *data = ::mmap(nullptr, size_, protection, flags, fd, 0);
+            if (data == MAP_FAILED) {
+                ::close(fd);
+                throw_error("Cannot map " + path);
+            }
+
+            data_ = data;
+        }
+
+        // the mapping stays valid after the descriptor is closed
+        ::close(fd);
+
+        advise(access);
+    }
+
+    MappedFile(MappedFile const &) = delete;
+    MappedFile &operator =(MappedFile const &) = delete;
+
+    ~MappedFile() {
+        if (data_) ::munmap(data_, size_);
+    }
+
+    void *data() const { return data_; }
+    std::size_t size() const { return size_; }
+    MapMode mode() const { return mode_; }
+
+    /**
+     * @brief Hints how the bytes in `[offset, offset + length)` will be read
+     */
+    void advise(MapAccess access, std::size_t offset=0, std::size_t length=std::string::npos) {
+        if (!data_ || offset >= size_) return;
+
+        // madvise needs a page-aligned start
+        auto page = std::size_t(::sysconf(_SC_PAGESIZE));
+        auto begin = offset/page*page;
+        auto end = length >= size_ - offset ? size_ : offset + length;
+
+        ::madvise(static_cast<char *>(data_) + begin, end - begin, advice(access));
+    }
+
+    /**
+     * @brief Writes modified pages of a `ReadWrite` mapping back to the file
+     */
+    void sync() {
+        if (data_ && mode_ == MapMode::ReadWrite && ::msync(data_, size_, MS_SYNC) != 0) {
+            throw_error("Cannot sync mapping");
+        }
+    }
+private:
+    [[noreturn]] static void throw_error(std::string const &what) {
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+
+    static int advice(MapAccess access) {
+        switch (access) {
+        case MapAccess::Sequential: return MADV_SEQUENTIAL;
+        case MapAccess::Random: return MADV_RANDOM;
+        case MapAccess::WillNeed: return MADV_WILLNEED;
+        default: return MADV_NORMAL;
+        }
+    }
+
+    void *data_ = nullptr;
+    std::size_t size_ = 0;
+    MapMode mode_;
+};
+
+/**
+ * @brief Returns storage over `size` elements of `file`, starting `offset`
+ *        bytes in. The storage keeps the mapping alive.
+ */
+template <typename T, typename Device=CPU>
+std::shared_ptr<Storage<T, Device>> map_storage(std::shared_ptr<MappedFile> const &file,
+                                                std::size_t size,
+                                                std::size_t offset=0)
+{
+    if (offset % alignof(T) != 0) {
+        throw std::invalid_argument("Offset of mapped elements is not aligned");
+    }
+
+    if (offset > file->size() || size > (file->size() - offset)/sizeof(T)) {
+        throw std::out_of_range("Mapped file is too small for the requested elements");
+    }
+
+    auto data = reinterpret_cast<T *>(static_cast<char *>(file->data()) + offset);
+    return std::make_shared<Storage<T, Device>>(data, size, file);
+}
+
+/**
+ * @brief Maps a tensor of `shape` stored in the file at `path`, starting
+ *        `offset` bytes in, without reading it. Slicing and iterating only
+ *        touches the pages that are used.
+ *
+ * With `MapMode::ReadOnly` the tensor must not be written to.
+ */
+template <typename T, typename Device=CPU>
+Tensor<T, Device> map_tensor(std::string const &path,
+                             extent const &shape,
+                             MapMode mode=MapMode::ReadOnly,
+                             MapAccess access=MapAccess::Normal,
+                             std::size_t offset=0,
+                             TensorOrder order=TensorOrder::RowMajor)
+{
+    auto file = std::make_shared<MappedFile>(path, mode, access);
+    auto storage = map_storage<T, Device>(file, ::num_elements(shape), offset);
+
+    return Tensor<T, Device>(storage, View(shape, make_order(shape.size(), order)));
+}
+
+#endif
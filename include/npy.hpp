@@ -0,0 +1,615 @@
+#ifndef NPY_HPP
+#define NPY_HPP
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "mapped_file.hpp"
+#include "tensor.hpp"
+#include "tensor_ops.hpp"
+
+/**
+ * Reading and writing of NumPy `.npy` files and uncompressed `.npz`
+ * archives (as written by `numpy.savez`).
+ *
+ * Arrays stored in Fortran order load as `TensorOrder::ColumnMajor`
+ * tensors, and dense column-major tensors are saved in Fortran order; any
+ * other tensor is saved in C (row-major) order. Files may also be mapped
+ * instead of read, in which case the tensor's storage is the file itself.
+ */
+
+struct NpyError: public TensorError {
+    NpyError(std::string const &path, std::string const &reason):
+        TensorError(fmt::format("{}: {}", path, reason)) {}
+};
+
+/**
+ * @brief Parsed header of a `.npy` array
+ */
+struct NpyHeader {
+    std::string descr;
+    bool fortran_order;
+    extent shape;
+
+    // bytes from the start of the array to its first element
+    std::size_t data_offset;
+};
+
+namespace detail {
+
+inline bool little_endian() {
+    std::uint16_t value = 1;
+    return *reinterpret_cast<unsigned char *>(&value) == 1;
+}
+
+// NumPy type string of `T`, e.g. "<f4"
+template <typename T>
+std::string npy_descr() {
+    static_assert(std::is_arithmetic_v<T>, ".npy files only hold arithmetic element types");
+
+    char kind;
+    if (std::is_same_v<T, bool>) {
+        kind = 'b';
+    } else if (std::is_floating_point_v<T>) {
+        kind = 'f';
+    } else if (std::is_signed_v<T>) {
+        kind = 'i';
+    } else {
+        kind = 'u';
+    }
+
+    char byte_order = sizeof(T) == 1 ? '|' : (little_endian() ? '<' : '>');
+    return fmt::format("{}{}{}", byte_order, kind, sizeof(T));
+}
+
+// true if `descr` describes `T` in the opposite byte order to the host's
+template <typename T>
+bool npy_check_descr(std::string const &path, std::string const &descr) {
+    auto expected = npy_descr<T>();
+    if (descr.size() < 2 || descr.substr(1) != expected.substr(1)) {
+        throw NpyError(path, fmt::format("element type {} does not match {}", descr, expected));
+    }
+
+    if (sizeof(T) == 1 || descr[0] == '=' || descr[0] == expected[0]) return false;
+    if (descr[0] != '<' && descr[0] != '>') {
+        throw NpyError(path, fmt::format("unknown byte order in {}", descr));
+    }
+
+    return true;
+}
+
+template <typename T>
+void byte_swap(T *data, std::size_t size) {
+    for (std::size_t i = 0; i < size; i++) {
+        auto bytes = reinterpret_cast<unsigned char *>(data + i);
+        std::reverse(bytes, bytes + sizeof(T));
+    }
+}
+
+constexpr char npy_magic[] = "\x93NUMPY";
+constexpr std::size_t npy_magic_size = 6;
+
+// bytes needed before the header dictionary can be located
+constexpr std::size_t npy_prefix_size = 12;
+
+// total size of the magic, version, length and dictionary of the header
+// starting at `data` (at least `npy_prefix_size` bytes)
+inline std::size_t npy_header_size(std::string const &path, char const *data) {
+    if (std::memcmp(data, npy_magic, npy_magic_size) != 0) {
+        throw NpyError(path, "not a .npy array");
+    }
+
+    auto bytes = reinterpret_cast<unsigned char const *>(data);
+    switch (bytes[6]) {
+    case 1:
+        return 10 + (bytes[8] | bytes[9] << 8);
+    case 2:
+    case 3:
+        return 12 + (bytes[8] | bytes[9] << 8 | bytes[10] << 16 | std::size_t(bytes[11]) << 24);
+    default:
+        throw NpyError(path, fmt::format("unsupported .npy version {}", int(bytes[6])));
+    }
+}
+
+// returns the text following `'key':` in a header dictionary
+inline char const *npy_find_key(std::string const &path, std::string const &dict,
+                                char const *key)
+{
+    auto pos = dict.find(fmt::format("'{}'", key));
+    if (pos == std::string::npos) throw NpyError(path, fmt::format("header has no '{}'", key));
+
+    pos = dict.find(':', pos);
+    if (pos == std::string::npos) throw NpyError(path, "malformed header");
+
+    auto value = dict.c_str() + pos + 1;
+    while (*value == ' ') ++value;
+    return value;
+}
+
+// parses the header at `data`, which must hold at least `npy_header_size`
+// bytes, for elements of `element_size` bytes
+inline NpyHeader npy_parse_header(std::string const &path, char const *data,
+                                  std::size_t element_size)
+{
+    NpyHeader header;
+    header.data_offset = npy_header_size(path, data);
+
+    auto dict_begin = data + (data[6] == 1 ? 10 : 12);
+    std::string dict(dict_begin, data + header.data_offset);
+
+    auto descr = npy_find_key(path, dict, "descr");
+    if (*descr != '\'') throw NpyError(path, "structured arrays are not supported");
+    auto descr_end = std::strchr(descr + 1, '\'');
+    if (!descr_end) throw NpyError(path, "malformed header");
+    header.descr.assign(descr + 1, descr_end);
+
+    auto fortran_order = npy_find_key(path, dict, "fortran_order");
+    header.fortran_order = std::strncmp(fortran_order, "True", 4) == 0;
+
+    auto shape = npy_find_key(path, dict, "shape");
+    if (*shape != '(') throw NpyError(path, "malformed shape");
+
+    // the file is untrusted, so reject shapes whose size in bytes doesn't fit
+    // in a std::size_t rather than letting the element count wrap
+    std::size_t bytes = element_size;
+    for (auto p = shape + 1; *p != ')'; ) {
+        if (*p == ',' || *p == ' ') {
+            ++p;
+        } else if (*p >= '0' && *p <= '9') {
+            char *end;
+            errno = 0;
+            auto dim = std::strtoull(p, &end, 10);
+            if (errno == ERANGE || dim > std::numeric_limits<index_t>::max() ||
+                (dim != 0 && bytes > std::numeric_limits<std::size_t>::max()/dim))
+            {
+                throw NpyError(path, "shape too large");
+            }
+
+            if (dim != 0) bytes *= dim;
+            header.shape.push_back(index_t(dim));
+            p = end;
+        } else {
+            throw NpyError(path, "malformed shape");
+        }
+    }
+
+    // 0-d arrays load as a single element
+    if (header.shape.empty()) header.shape.push_back(1);
+
+    return header;
+}
+
+// serialized header for a `shape` array of `T`, padded so that the data
+// after it is 64-byte aligned
+template <typename T>
+std::string npy_make_header(extent const &shape, bool fortran_order) {
+    std::string shape_text;
+    for (auto dim : shape) shape_text += fmt::format("{}, ", dim);
+    if (shape.size() > 1) shape_text.resize(shape_text.size() - 2);
+    if (shape.size() == 1) shape_text.pop_back();
+
+    auto dict = fmt::format("{{'descr': '{}', 'fortran_order': {}, 'shape': ({}), }}",
+                            npy_descr<T>(), fortran_order ? "True" : "False", shape_text);
+
+    // version 1.0 stores the length in 16 bits
+    bool large = dict.size() + 11 + 64 > 0xffff;
+    std::size_t prefix = large ? 12 : 10;
+    std::size_t total = (prefix + dict.size() + 1 + 63)/64*64;
+    dict.append(total - prefix - dict.size() - 1, ' ');
+    dict += '\n';
+
+    std::string header(npy_magic, npy_magic_size);
+    header += char(large ? 2 : 1);
+    header += char(0);
+
+    auto length = dict.size();
+    for (std::size_t i = 0; i < prefix - 8; i++) {
+        header += char((length >> (8*i)) & 0xff);
+    }
+
+    return header + dict;
+}
+
+// writes `t` as a .npy array through `sink.write(data, size)`
+template <typename T, typename Device, typename Sink>
+void npy_write(Sink &sink, Tensor<T, Device> const &t) {
+    auto dims = t.num_dims();
+    bool row_major = is_contiguous(View(t.shape(), make_row_major_order(dims), t.strides()));
+    bool col_major = !row_major &&
+        is_contiguous(View(t.shape(), make_col_major_order(dims), t.strides()));
+
+    auto header = npy_make_header<T>(t.shape(), col_major);
+    sink.write(header.data(), header.size());
+
+    // anything that isn't already dense is written in row-major order
+    auto dense = row_major || col_major ? t : copy(t);
+    sink.write(reinterpret_cast<char const *>(dense.data()), num_elements(t)*sizeof(T));
+}
+
+struct StreamSink {
+    std::ostream &out;
+
+    void write(char const *data, std::size_t size) {
+        out.write(data, std::streamsize(size));
+    }
+};
+
+// reads the .npy array starting at the current position of `in`
+template <typename T, typename Device>
+Tensor<T, Device> npy_read(std::string const &path, std::istream &in) {
+    std::vector<char> buffer(npy_prefix_size);
+    if (!in.read(buffer.data(), npy_prefix_size)) throw NpyError(path, "truncated header");
+
+    auto header_size = npy_header_size(path, buffer.data());
+    if (header_size < npy_prefix_size) throw NpyError(path, "malformed header");
+
+    buffer.resize(header_size);
+    if (!in.read(buffer.data() + npy_prefix_size, header_size - npy_prefix_size)) {
+        throw NpyError(path, "truncated header");
+    }
+
+    auto header = npy_parse_header(path, buffer.data(), sizeof(T));
+    bool swap = npy_check_descr<T>(path, header.descr);
+
+    auto order = header.fortran_order ? TensorOrder::ColumnMajor : TensorOrder::RowMajor;
+    Tensor<T, Device> result(header.shape, uninitialized, order);
+
+    auto size = num_elements(header.shape);
+    if (!in.read(reinterpret_cast<char *>(result.data()), std::streamsize(size*sizeof(T)))) {
+        throw NpyError(path, "truncated data");
+    }
+
+    if (swap) byte_swap(result.data(), size);
+    return result;
+}
+
+// maps the .npy array `offset` bytes into `file`, or reads it if its data
+// isn't aligned for `T`
+template <typename T, typename Device>
+Tensor<T, Device> npy_map(std::string const &path, std::shared_ptr<MappedFile> const &file,
+                          std::size_t offset)
+{
+    auto data = static_cast<char const *>(file->data());
+    if (offset + npy_prefix_size > file->size() ||
+        offset + npy_header_size(path, data + offset) > file->size())
+    {
+        throw NpyError(path, "truncated header");
+    }
+
+    auto header = npy_parse_header(path, data + offset, sizeof(T));
+    if (npy_check_descr<T>(path, header.descr)) {
+        throw NpyError(path, "cannot map an array stored in non-native byte order");
+    }
+
+    auto size = num_elements(header.shape);
+    auto data_offset = offset + header.data_offset;
+    if (size*sizeof(T) > file->size() - data_offset) throw NpyError(path, "truncated data");
+
+    auto order = header.fortran_order ? TensorOrder::ColumnMajor : TensorOrder::RowMajor;
+
+    if (data_offset % alignof(T) != 0) {
+        Tensor<T, Device> result(header.shape, uninitialized, order);
+        std::memcpy(result.data(), data + data_offset, size*sizeof(T));
+        return result;
+    }
+
+    return Tensor<T, Device>(map_storage<T, Device>(file, size, data_offset),
+                             View(header.shape, make_order(header.shape.size(), order)));
+}
+
+// little-endian zip fields
+template <typename U>
+U zip_read(char const *data) {
+    U value = 0;
+    for (std::size_t i = 0; i < sizeof(U); i++) {
+        value |= U(static_cast<unsigned char>(data[i])) << (8*i);
+    }
+    return value;
+}
+
+template <typename U>
+void zip_write(std::string &out, U value) {
+    for (std::size_t i = 0; i < sizeof(U); i++) {
+        out += char((value >> (8*i)) & 0xff);
+    }
+}
+
+inline std::uint32_t crc32_update(std::uint32_t crc, char const *data, std::size_t size) {
+    static auto const table = [] {
+        std::array<std::uint32_t, 256> table{};
+        for (std::uint32_t i = 0; i < 256; i++) {
+            std::uint32_t c = i;
+            for (int k = 0; k < 8; k++) {
+                c = c & 1 ? 0xedb88320u ^ (c >> 1) : c >> 1;
+            }
+            table[i] = c;
+        }
+        return table;
+    }();
+
+    crc = ~crc;
+    for (std::size_t i = 0; i < size; i++) {
+        crc = table[(crc ^ static_cast<unsigned char>(data[i])) & 0xff] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+// writes through to a stream, keeping the CRC-32 and size of what was written
+struct ZipEntrySink {
+    std::ostream &out;
+    std::uint32_t crc = 0;
+    std::uint64_t size = 0;
+
+    void write(char const *data, std::size_t count) {
+        crc = crc32_update(crc, data, count);
+        size += count;
+        out.write(data, std::streamsize(count));
+    }
+};
+
+struct ZipEntry {
+    std::string name;
+    std::uint64_t offset;
+};
+
+// the stored (uncompressed) members of the zip archive at `path`, with the
+// offset of each member's data
+inline std::vector<ZipEntry> zip_entries(std::string const &path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) throw NpyError(path, "cannot open");
+
+    in.seekg(0, std::ios::end);
+    std::uint64_t file_size = std::uint64_t(in.tellg());
+
+    // the end of central directory record is followed by at most a 64 KiB comment
+    std::uint64_t tail_size = std::min<std::uint64_t>(file_size, 22 + 0xffff);
+    std::vector<char> tail(tail_size);
+    in.seekg(std::streamoff(file_size - tail_size));
+    in.read(tail.data(), std::streamsize(tail_size));
+
+    std::int64_t end_record = -1;
+    for (std::int64_t i = std::int64_t(tail_size) - 22; i >= 0; i--) {
+        if (zip_read<std::uint32_t>(tail.data() + i) == 0x06054b50) {
+            end_record = i;
+            break;
+        }
+    }
+    if (end_record < 0) throw NpyError(path, "not a zip archive");
+
+    auto count = zip_read<std::uint16_t>(tail.data() + end_record + 10);
+    auto directory_size = zip_read<std::uint32_t>(tail.data() + end_record + 12);
+    auto directory_offset = zip_read<std::uint32_t>(tail.data() + end_record + 16);
+    if (count == 0xffff || directory_offset == 0xffffffff) {
+        throw NpyError(path, "ZIP64 archives are not supported");
+    }
+
+    std::vector<char> directory(directory_size);
+    in.seekg(directory_offset);
+    if (!in.read(directory.data(), directory_size)) throw NpyError(path, "truncated zip directory");
+
+    std::vector<ZipEntry> entries;
+    std::size_t pos = 0;
+    for (std::uint16_t i = 0; i < count; i++) {
+        auto record = directory.data() + pos;
+        if (pos + 46 > directory.size() || zip_read<std::uint32_t>(record) != 0x02014b50) {
+            throw NpyError(path, "malformed zip directory");
+        }
+
+        auto method = zip_read<std::uint16_t>(record + 10);
+        auto name_size = zip_read<std::uint16_t>(record + 28);
+        auto extra_size = zip_read<std::uint16_t>(record + 30);
+        auto comment_size = zip_read<std::uint16_t>(record + 32);
+        auto local_offset = zip_read<std::uint32_t>(record + 42);
+        std::string name(record + 46, name_size);
+
+        if (method != 0) throw NpyError(path, fmt::format("{} is compressed", name));
+        if (local_offset == 0xffffffff) throw NpyError(path, "ZIP64 archives are not supported");
+
+        // the local header may carry a different extra field
+        char local[30];
+        in.seekg(local_offset);
+        if (!in.read(local, 30) || zip_read<std::uint32_t>(local) != 0x04034b50) {
+            throw NpyError(path, fmt::format("malformed zip entry {}", name));
+        }
+
+        std::uint64_t offset = local_offset + 30 + zip_read<std::uint16_t>(local + 26) +
+                               zip_read<std::uint16_t>(local + 28);
+        entries.push_back({name, offset});
+
+        pos += 46 + name_size + extra_size + comment_size;
+    }
+
+    return entries;
+}
+
+// name of the array held by an npz member ("weights.npy" -> "weights")
+inline std::string npz_array_name(std::string const &member) {
+    auto size = member.size();
+    if (size >= 4 && member.compare(size - 4, 4, ".npy") == 0) return member.substr(0, size - 4);
+    return member;
+}
+
+} // namespace detail
+
+/**
+ * @brief Writes `t` to `path` as a `.npy` array
+ */
+template <typename T, typename Device>
+void save_npy(std::string const &path, Tensor<T, Device> const &t) {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) throw NpyError(path, "cannot open for writing");
+
+    detail::StreamSink sink{out};
+    detail::npy_write(sink, t);
+
+    if (!out) throw NpyError(path, "write failed");
+}
+
+/**
+ * @brief Reads the `.npy` array at `path`. The file's element type must be
+ *        `T`; arrays in the other byte order are swapped while reading.
+ */
+template <typename T, typename Device=CPU>
+Tensor<T, Device> load_npy(std::string const &path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) throw NpyError(path, "cannot open");
+
+    return detail::npy_read<T, Device>(path, in);
+}
+
+/**
+ * @brief Maps the `.npy` array at `path` without reading it: the tensor's
+ *        storage is the file itself (see `map_tensor`)
+ */
+template <typename T, typename Device=CPU>
+Tensor<T, Device> map_npy(std::string const &path,
+                          MapMode mode=MapMode::ReadOnly,
+                          MapAccess access=MapAccess::Normal)
+{
+    auto file = std::make_shared<MappedFile>(path, mode, access);
+    return detail::npy_map<T, Device>(path, file, 0);
+}
+
+/**
+ * @brief Writes `arrays` to `path` as an uncompressed `.npz` archive, each
+ *        array stored as `<name>.npy`. The data of each array is aligned to
+ *        64 bytes, so archives written here can always be mapped.
+ */
+template <typename T, typename Device>
+void save_npz(std::string const &path, std::map<std::string, Tensor<T, Device>> const &arrays) {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) throw NpyError(path, "cannot open for writing");
+
+    std::string directory;
+    for (auto const &array : arrays) {
+        auto name = array.first + ".npy";
+        std::uint64_t offset = std::uint64_t(out.tellp());
+
+        // pad the extra field (with a zipalign record) so the data starts on
+        // a 64-byte boundary; npy headers are themselves multiples of 64
+        std::size_t padding = (64 - (offset + 30 + name.size()) % 64) % 64;
+        if (padding > 0 && padding < 4) padding += 64;
+
+        std::string local;
+        detail::zip_write<std::uint32_t>(local, 0x04034b50);
+        detail::zip_write<std::uint16_t>(local, 20);        // version needed
+        detail::zip_write<std::uint16_t>(local, 0);         // flags
+        detail::zip_write<std::uint16_t>(local, 0);         // stored
+        detail::zip_write<std::uint16_t>(local, 0);         // time
+        detail::zip_write<std::uint16_t>(local, 0x21);      // date (1980-01-01)
+        detail::zip_write<std::uint32_t>(local, 0);         // crc, patched below
+        detail::zip_write<std::uint32_t>(local, 0);         // compressed size
+        detail::zip_write<std::uint32_t>(local, 0);         // size
+        detail::zip_write<std::uint16_t>(local, std::uint16_t(name.size()));
+        detail::zip_write<std::uint16_t>(local, std::uint16_t(padding));
+        local += name;
+        if (padding > 0) {
+            detail::zip_write<std::uint16_t>(local, 0xd935);
+            detail::zip_write<std::uint16_t>(local, std::uint16_t(padding - 4));
+            local.append(padding - 4, '\0');
+        }
+        out.write(local.data(), std::streamsize(local.size()));
+
+        detail::ZipEntrySink sink{out};
+        detail::npy_write(sink, array.second);
+
+        if (sink.size >= 0xffffffff || offset >= 0xffffffff) {
+            throw NpyError(path, "archives over 4 GiB need ZIP64, which is not supported");
+        }
+
+        auto end = out.tellp();
+        std::string sizes;
+        detail::zip_write<std::uint32_t>(sizes, sink.crc);
+        detail::zip_write<std::uint32_t>(sizes, std::uint32_t(sink.size));
+        detail::zip_write<std::uint32_t>(sizes, std::uint32_t(sink.size));
+        out.seekp(std::streamoff(offset + 14));
+        out.write(sizes.data(), std::streamsize(sizes.size()));
+        out.seekp(end);
+
+        detail::zip_write<std::uint32_t>(directory, 0x02014b50);
+        detail::zip_write<std::uint16_t>(directory, 20);    // version made by
+        directory.append(local, 4, 26);                     // same fields as the local header
+        directory.replace(directory.size() - 2, 2, 2, '\0'); // no extra field
+        directory.replace(directory.size() - 16, 12, sizes);
+        detail::zip_write<std::uint16_t>(directory, 0);     // comment
+        detail::zip_write<std::uint16_t>(directory, 0);     // disk
+        detail::zip_write<std::uint16_t>(directory, 0);     // internal attributes
+        detail::zip_write<std::uint32_t>(directory, 0);     // external attributes
+        detail::zip_write<std::uint32_t>(directory, std::uint32_t(offset));
+        directory += name;
+    }
+
+    std::uint64_t directory_offset = std::uint64_t(out.tellp());
+    if (directory_offset >= 0xffffffff) {
+        throw NpyError(path, "archives over 4 GiB need ZIP64, which is not supported");
+    }
+
+    std::string end;
+    detail::zip_write<std::uint32_t>(end, 0x06054b50);
+    detail::zip_write<std::uint16_t>(end, 0);
+    detail::zip_write<std::uint16_t>(end, 0);
+    detail::zip_write<std::uint16_t>(end, std::uint16_t(arrays.size()));
+    detail::zip_write<std::uint16_t>(end, std::uint16_t(arrays.size()));
+    detail::zip_write<std::uint32_t>(end, std::uint32_t(directory.size()));
+    detail::zip_write<std::uint32_t>(end, std::uint32_t(directory_offset));
+    detail::zip_write<std::uint16_t>(end, 0);
+
+    out.write(directory.data(), std::streamsize(directory.size()));
+    out.write(end.data(), std::streamsize(end.size()));
+
+    if (!out) throw NpyError(path, "write failed");
+}
+
+/**
+ * @brief Reads every array of the `.npz` archive at `path`, by name. All
+ *        arrays must have element type `T`; compressed archives
+ *        (`numpy.savez_compressed`) are not supported.
+ */
+template <typename T, typename Device=CPU>
+std::map<std::string, Tensor<T, Device>> load_npz(std::string const &path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) throw NpyError(path, "cannot open");
+
+    std::map<std::string, Tensor<T, Device>> arrays;
+    for (auto const &entry : detail::zip_entries(path)) {
+        in.seekg(std::streamoff(entry.offset));
+        arrays.emplace(detail::npz_array_name(entry.name),
+                       detail::npy_read<T, Device>(path + "/" + entry.name, in));
+    }
+
+    return arrays;
+}
+
+/**
+ * @brief Maps every array of the `.npz` archive at `path` without reading
+ *        them. Arrays whose data is not aligned for `T` within the archive
+ *        (possible in archives written by NumPy) are read instead.
+ */
+template <typename T, typename Device=CPU>
+std::map<std::string, Tensor<T, Device>> map_npz(std::string const &path,
+                                                 MapMode mode=MapMode::ReadOnly,
+                                                 MapAccess access=MapAccess::Normal)
+{
+    auto entries = detail::zip_entries(path);
+    auto file = std::make_shared<MappedFile>(path, mode, access);
+
+    std::map<std::string, Tensor<T, Device>> arrays;
+    for (auto const &entry : entries) {
+        arrays.emplace(detail::npz_array_name(entry.name),
+                       detail::npy_map<T, Device>(path + "/" + entry.name, file, entry.offset));
+    }
+
+    return arrays;
+}
+
+#endif
@@ -0,0 +1,284 @@
+#ifndef PROFILE_HPP
+#define PROFILE_HPP
+
+/**
+ * Per-op profiling, compiled in only when `TENSOR_PROFILE` is defined (the
+ * CMake option of the same name defines it for every target). Without it
+ * the `TENSOR_PROFILE_*` macros expand to nothing and none of their arguments
+ * are evaluated.
+ *
+ * With it, instrumented ops (`apply`, `iapply`, `product`, `reshape`, `copy`
+ * and `broadcast_to`) are recorded while `profiler().start()` is in effect:
+ *
+ *     profiler().start();
+ *     run_model(input);
+ *     profiler().stop();
+ *
+ *     std::ofstream trace("trace.json");
+ *     profiler().write_chrome_trace(trace);    // open in chrome://tracing
+ *     fmt::print("{}", profiler().summary());
+ *
+ * Evaluating an elementwise expression such as `a + b - c` records a single
+ * `apply` (`iapply` for `+=` and friends) with the shapes of all its operands.
+ */
+
+#ifdef TENSOR_PROFILE
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <initializer_list>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+#include <fmt/ranges.h>
+
+#include "allocator.hpp"
+#include "types.hpp"
+
+/**
+ * @brief One recorded call of a tensor op
+ */
+struct ProfileEvent {
+    char const *name;
+
+    // shapes of the operands
+    std::vector<extent> shapes;
+
+    // bytes of elements read and written; broadcast elements count each
+    // time they are read
+    std::size_t bytes;
+
+    // start time and duration in nanoseconds, from when the profiler was
+    // created
+    std::int64_t start;
+    std::int64_t duration;
+
+    // storage allocations made by the op, including those of the ops it
+    // calls
+    std::size_t allocations;
+
+    // small integer identifying the calling thread
+    std::size_t thread;
+};
+
+/**
+ * @brief Collects `ProfileEvent`s from every thread.
+ *
+ * Events of ops called by other ops (e.g. the `copy` done by `reshape`) are
+ * recorded too, nested inside their caller; the time, bytes and allocations
+ * of an event include those of its nested events.
+ */
+class Profiler {
+public:
+    Profiler(Profiler const &) = delete;
+    Profiler &operator =(Profiler const &) = delete;
+
+    /**
+     * @brief Starts recording, keeping any events already recorded
+     */
+    void start() { enabled_ = true; }
+
+    void stop() { enabled_ = false; }
+
+    bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        events_.clear();
+    }
+
+    std::vector<ProfileEvent> events() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return events_;
+    }
+
+    void record(ProfileEvent event) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        events_.push_back(std::move(event));
+    }
+
+    /**
+     * @brief Nanoseconds since the profiler was created
+     */
+    std::int64_t now() const {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - epoch_).count();
+    }
+
+    /**
+     * @brief Writes the recorded events in the Chrome trace event format,
+     *        readable by chrome://tracing and Perfetto
+     */
+    void write_chrome_trace(std::ostream &os) const {
+        fmt::memory_buffer buffer;
+        fmt::format_to(std::back_inserter(buffer), "{{\"traceEvents\": [");
+
+        auto events = this->events();
+        for (std::size_t i = 0; i < events.size(); i++) {
+            auto const &event = events[i];
+            fmt::format_to(std::back_inserter(buffer),
+                "{}\n{{\"name\": \"{}\", \"cat\": \"tensor\", \"ph\": \"X\", "
+                "\"ts\": {:.3f}, \"dur\": {:.3f}, \"pid\": 0, \"tid\": {}, "
+                "\"args\": {{\"shapes\": \"{}\", \"bytes\": {}, \"allocations\": {}}}}}",
+                i == 0 ? "" : ",", event.name, event.start/1e3, event.duration/1e3,
+                event.thread, fmt::join(event.shapes, " "), event.bytes, event.allocations);
+        }
+
+        fmt::format_to(std::back_inserter(buffer), "\n], \"displayTimeUnit\": \"ns\"}}\n");
+        os.write(buffer.data(), buffer.size());
+    }
+
+    /**
+     * @brief Table of the calls, total and mean time, throughput and
+     *        allocations of each op, slowest op first
+     */
+    std::string summary() const {
+        struct Totals {
+            std::size_t calls = 0;
+            std::int64_t duration = 0;
+            std::size_t bytes = 0;
+            std::size_t allocations = 0;
+        };
+
+        std::map<std::string, Totals> ops;
+        for (auto const &event : events()) {
+            auto &totals = ops[event.name];
+            totals.calls++;
+            totals.duration += event.duration;
+            totals.bytes += event.bytes;
+            totals.allocations += event.allocations;
+        }
+
+        std::vector<std::pair<std::string, Totals>> rows(ops.begin(), ops.end());
+        std::stable_sort(rows.begin(), rows.end(), [](auto const &lhs, auto const &rhs) {
+            return lhs.second.duration > rhs.second.duration;
+        });
+
+        fmt::memory_buffer buffer;
+        auto out = std::back_inserter(buffer);
+        fmt::format_to(out, "{:<16}{:>10}{:>14}{:>14}{:>12}{:>14}\n",
+                       "op", "calls", "total ms", "mean us", "GB/s", "allocations");
+
+        for (auto const &[name, totals] : rows) {
+            double seconds = totals.duration/1e9;
+            fmt::format_to(out, "{:<16}{:>10}{:>14.3f}{:>14.3f}{:>12.2f}{:>14}\n",
+                           name, totals.calls, seconds*1e3, seconds*1e6/totals.calls,
+                           seconds > 0 ? totals.bytes/seconds/1e9 : 0.0, totals.allocations);
+        }
+
+        return fmt::to_string(buffer);
+    }
+private:
+    friend Profiler &profiler();
+
+    Profiler(): epoch_(std::chrono::steady_clock::now()) {}
+
+    std::chrono::steady_clock::time_point epoch_;
+    std::atomic<bool> enabled_{false};
+
+    mutable std::mutex mutex_;
+    std::vector<ProfileEvent> events_;
+};
+
+/**
+ * @brief The profiler instrumented ops record to
+ */
+inline Profiler &profiler() {
+    static Profiler *instance = new Profiler();
+    return *instance;
+}
+
+namespace detail {
+
+inline std::size_t profile_thread_id() {
+    static std::atomic<std::size_t> next{0};
+    thread_local std::size_t id = next++;
+    return id;
+}
+
+} // namespace detail
+
+/**
+ * @brief Records the op running for its lifetime, if the profiler is
+ *        recording when it is created. Used through `TENSOR_PROFILE_OP`.
+ */
+class ProfileScope {
+public:
+    explicit ProfileScope(char const *name): active_(profiler().enabled()) {
+        if (!active_) return;
+
+        event_.name = name;
+        event_.bytes = 0;
+        event_.allocations = detail::storage_allocations();
+        event_.thread = detail::profile_thread_id();
+        event_.start = profiler().now();
+    }
+
+    ProfileScope(ProfileScope const &) = delete;
+    ProfileScope &operator =(ProfileScope const &) = delete;
+
+    ~ProfileScope() {
+        if (!active_) return;
+
+        event_.duration = profiler().now() - event_.start;
+        event_.allocations = detail::storage_allocations() - event_.allocations;
+        profiler().record(std::move(event_));
+    }
+
+    bool active() const { return active_; }
+
+    void describe(std::size_t bytes, std::initializer_list<extent> shapes) {
+        event_.bytes += bytes;
+        event_.shapes.assign(shapes.begin(), shapes.end());
+    }
+
+    template <typename Operands>
+    void describe_operands(std::size_t bytes, Operands const &operands) {
+        event_.bytes += bytes;
+        for (auto const &operand : operands) event_.shapes.push_back(operand.shape());
+    }
+
+    void add_bytes(std::size_t bytes) { event_.bytes += bytes; }
+private:
+    bool active_;
+    ProfileEvent event_;
+};
+
+/**
+ * @brief Records the rest of the enclosing scope as a call of op `name`,
+ *        moving `bytes` bytes, with operands of the given shapes
+ */
+#define TENSOR_PROFILE_OP(name, bytes, ...) \
+    ProfileScope tensor_profile_scope_(name); \
+    if (tensor_profile_scope_.active()) tensor_profile_scope_.describe(bytes, {__VA_ARGS__})
+
+/**
+ * @brief Like `TENSOR_PROFILE_OP`, taking the operand shapes from a container
+ *        of tensors, for ops with any number of operands
+ */
+#define TENSOR_PROFILE_OPERANDS(name, bytes, operands) \
+    ProfileScope tensor_profile_scope_(name); \
+    if (tensor_profile_scope_.active()) tensor_profile_scope_.describe_operands(bytes, operands)
+
+/**
+ * @brief Adds `bytes` to the op recorded by `TENSOR_PROFILE_OP` in this scope,
+ *        for results whose size is only known at the end
+ */
+#define TENSOR_PROFILE_ADD_BYTES(bytes) \
+    if (tensor_profile_scope_.active()) tensor_profile_scope_.add_bytes(bytes)
+
+#else
+
+#define TENSOR_PROFILE_OP(name, bytes, ...) ((void)0)
+#define TENSOR_PROFILE_OPERANDS(name, bytes, operands) ((void)0)
+#define TENSOR_PROFILE_ADD_BYTES(bytes) ((void)0)
+
+#endif
+
+#endif
@@ -0,0 +1,698 @@
+#ifndef REDUCE_HPP
+#define REDUCE_HPP
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <type_traits>
+#include <vector>
+
+#include <fmt/format.h>
+#include <fmt/ranges.h>
+
+#include "tensor.hpp"
+#include "tensor_ops.hpp"
+#include "simd.hpp"
+#include "thread_pool.hpp"
+#include "types.hpp"
+
+struct InvalidAxes: public TensorError {
+    InvalidAxes(indices const &axes, extent const &shape):
+        TensorError(fmt::format("Invalid reduction axes {} for shape {}", axes, shape)) {}
+};
+
+struct EmptyReduction: public TensorError {
+    EmptyReduction(extent const &shape):
+        TensorError(fmt::format("Reduction has no identity and shape {} is empty", shape)) {}
+};
+
+namespace reduce_ops {
+
+template <typename T>
+struct Sum {
+    using accumulator = T;
+    using result_type = T;
+    static constexpr bool has_identity = true;
+
+    T identity() const { return T(0); }
+    T load(T value, index_t) const { return value; }
+    T combine(T lhs, T rhs) const { return lhs + rhs; }
+    T finish(T value, index_t) const { return value; }
+};
+
+template <typename T>
+struct Prod {
+    using accumulator = T;
+    using result_type = T;
+    static constexpr bool has_identity = true;
+
+    T identity() const { return T(1); }
+    T load(T value, index_t) const { return value; }
+    T combine(T lhs, T rhs) const { return lhs*rhs; }
+    T finish(T value, index_t) const { return value; }
+};
+
+// integer tensors are averaged in double precision, like NumPy
+template <typename T>
+using mean_type = std::conditional_t<std::is_floating_point_v<T>, T, double>;
+
+template <typename T>
+struct Mean {
+    using accumulator = mean_type<T>;
+    using result_type = mean_type<T>;
+    static constexpr bool has_identity = true;
+
+    accumulator identity() const { return accumulator(0); }
+    accumulator load(T value, index_t) const { return accumulator(value); }
+    accumulator combine(accumulator lhs, accumulator rhs) const { return lhs + rhs; }
+    result_type finish(accumulator value, index_t count) const { return value/result_type(count); }
+};
+
+// NaNs propagate: the result of max or min over a NaN is NaN
+template <typename T>
+struct Max {
+    using accumulator = T;
+    using result_type = T;
+    static constexpr bool has_identity = false;
+
+    T identity() const { return T(); }
+    T load(T value, index_t) const { return value; }
+    T combine(T lhs, T rhs) const { return (lhs != lhs || lhs > rhs) ? lhs : rhs; }
+    T finish(T value, index_t) const { return value; }
+};
+
+template <typename T>
+struct Min {
+    using accumulator = T;
+    using result_type = T;
+    static constexpr bool has_identity = false;
+
+    T identity() const { return T(); }
+    T load(T value, index_t) const { return value; }
+    T combine(T lhs, T rhs) const { return (lhs != lhs || lhs < rhs) ? lhs : rhs; }
+    T finish(T value, index_t) const { return value; }
+};
+
+template <typename T>
+struct ValueIndex {
+    T value;
+    index_t index;
+};
+
+// the first occurrence wins ties, and the first NaN wins over everything, so
+// the result does not depend on the order partial results are combined in
+template <typename T, bool Greater>
+struct ArgExtreme {
+    using accumulator = ValueIndex<T>;
+    using result_type = index_t;
+    static constexpr bool has_identity = false;
+
+    accumulator identity() const { return {T(), 0}; }
+    accumulator load(T value, index_t index) const { return {value, index}; }
+
+    accumulator combine(accumulator lhs, accumulator rhs) const {
+        bool lhs_nan = lhs.value != lhs.value;
+        bool rhs_nan = rhs.value != rhs.value;
+        if (lhs_nan || rhs_nan) {
+            if (lhs_nan && rhs_nan) return lhs.index < rhs.index ? lhs : rhs;
+            return lhs_nan ? lhs : rhs;
+        }
+
+        if (lhs.value == rhs.value) return lhs.index < rhs.index ? lhs : rhs;
+        return (Greater ? rhs.value > lhs.value : rhs.value < lhs.value) ? rhs : lhs;
+    }
+
+    index_t finish(accumulator value, index_t) const { return value.index; }
+};
+
+template <typename T>
+using ArgMax = ArgExtreme<T, true>;
+
+template <typename T>
+using ArgMin = ArgExtreme<T, false>;
+
+} // namespace reduce_ops
+
+namespace detail {
+
+// elements reduced serially before partial results are combined pairwise
+constexpr index_t reduce_block_size = 1024;
+
+// blocks reduced by one task when a single output is split across threads
+constexpr index_t reduce_group_size = 64;
+
+// rows accumulated serially before partial rows are combined pairwise
+constexpr index_t reduce_row_block = 16;
+
+// columns accumulated together when reducing over an outer dimension
+constexpr index_t reduce_column_block = 256;
+
+/**
+ * @brief Combines a sequence of partial results as a balanced binary tree,
+ *        using O(log n) space: partials covering the same number of leaves
+ *        are merged as soon as both exist, like carries in a binary counter.
+ */
+template <typename Op>
+class PairwiseCombiner {
+public:
+    using accumulator = typename Op::accumulator;
+
+    explicit PairwiseCombiner(Op const &op): op_(op) {}
+
+    void push(accumulator value) {
+        index_t leaves = 1;
+        while (top_ > 0 && leaves_[top_-1] == leaves) {
+            value = op_.combine(stack_[--top_], value);
+            leaves *= 2;
+        }
+
+        stack_[top_] = value;
+        leaves_[top_] = leaves;
+        top_++;
+    }
+
+    bool empty() const { return top_ == 0; }
+
+    // callers always push at least once; an empty combiner yields a
+    // value-initialized accumulator rather than reading past the stack
+    accumulator result() const {
+        std::size_t i = top_ > 0 ? top_-1 : 0;
+        accumulator value = stack_[i];
+        while (i-- > 0) {
+            value = op_.combine(stack_[i], value);
+        }
+
+        return value;
+    }
+private:
+    Op const &op_;
+    std::array<accumulator, 64> stack_{};
+    std::array<index_t, 64> leaves_{};
+    std::size_t top_ = 0;
+};
+
+/**
+ * @brief Reduces `size` elements `stride` apart, starting at `data`, into
+ *        eight interleaved accumulators that are combined as a tree at the
+ *        end. With a unit stride the inner loop vectorizes.
+ */
+template <typename Op, typename T>
+typename Op::accumulator reduce_span(Op const &op, T const *data, index_t size, index_t stride,
+                                     index_t first_index)
+{
+    using accumulator = typename Op::accumulator;
+    constexpr index_t lanes = 8;
+
+    if (size < lanes) {
+        accumulator value = op.load(data[0], first_index);
+        for (index_t i = 1; i < size; i++) {
+            value = op.combine(value, op.load(data[i*stride], first_index + i));
+        }
+
+        return value;
+    }
+
+    std::array<accumulator, lanes> partial;
+    for (index_t j = 0; j < lanes; j++) {
+        partial[j] = op.load(data[j*stride], first_index + j);
+    }
+
+    index_t i = lanes;
+    for (; i + lanes <= size; i += lanes) {
+        for (index_t j = 0; j < lanes; j++) {
+            partial[j] = op.combine(partial[j], op.load(data[(i+j)*stride], first_index + i + j));
+        }
+    }
+
+    accumulator value = op.combine(op.combine(op.combine(partial[0], partial[1]),
+                                              op.combine(partial[2], partial[3])),
+                                   op.combine(op.combine(partial[4], partial[5]),
+                                              op.combine(partial[6], partial[7])));
+
+    for (; i < size; i++) {
+        value = op.combine(value, op.load(data[i*stride], first_index + i));
+    }
+
+    return value;
+}
+
+/**
+ * @brief Splits the elements visited by a reduction loop into blocks of at
+ *        most `reduce_block_size` elements: long runs are cut into pieces,
+ *        short runs are gathered several to a block. The blocks only depend
+ *        on the loop, never on the number of threads.
+ */
+struct ReduceBlocks {
+    explicit ReduceBlocks(LoopLayout const &loop):
+        loop(loop),
+        span_size(loop.shape[0]),
+        stride(loop.strides[0][0]),
+        num_spans(::num_spans(loop)),
+        pieces_per_span(std::max<index_t>(1, (span_size + reduce_block_size - 1)/reduce_block_size)),
+        spans_per_block(std::max<index_t>(1, reduce_block_size/std::max<index_t>(1, span_size))),
+        count(pieces_per_span > 1 ? num_spans*pieces_per_span
+                                  : (num_spans + spans_per_block - 1)/spans_per_block) {}
+
+    LoopLayout const &loop;
+    index_t span_size;
+    index_t stride;
+    index_t num_spans;
+    index_t pieces_per_span;
+    index_t spans_per_block;
+    index_t count;
+};
+
+// see `reduce_blocks`
+template <typename Op, typename T>
+typename Op::accumulator reduce_block_range(Op const &op, T const *data, ReduceBlocks const &blocks,
+                                            index_t begin, index_t end)
+{
+    using accumulator = typename Op::accumulator;
+
+    PairwiseCombiner<Op> combiner(op);
+    auto span_size = blocks.span_size;
+
+    if (blocks.pieces_per_span > 1) {
+        index_t span = begin/blocks.pieces_per_span;
+        index_t last_span = (end - 1)/blocks.pieces_per_span + 1;
+
+        for_each_span<1>(blocks.loop, {0}, span, last_span, [&](auto const &offsets, index_t) {
+            index_t first = span*blocks.pieces_per_span;
+            index_t piece = begin > first ? begin - first : 0;
+            index_t last_piece = std::min(blocks.pieces_per_span, end - first);
+
+            for (; piece < last_piece; piece++) {
+                index_t start = piece*reduce_block_size;
+                index_t size = std::min(reduce_block_size, span_size - start);
+                combiner.push(reduce_span(op, data + offsets[0] + start*blocks.stride, size,
+                                          blocks.stride, span*span_size + start));
+            }
+
+            span++;
+        });
+    } else {
+        index_t span = begin*blocks.spans_per_block;
+        index_t last_span = std::min(blocks.num_spans, end*blocks.spans_per_block);
+        accumulator block{};
+
+        for_each_span<1>(blocks.loop, {0}, span, last_span, [&](auto const &offsets, index_t) {
+            auto value = reduce_span(op, data + offsets[0], span_size, blocks.stride, span*span_size);
+            index_t position = span % blocks.spans_per_block;
+            block = position == 0 ? value : op.combine(block, value);
+
+            span++;
+            if (position == blocks.spans_per_block - 1 || span == last_span) combiner.push(block);
+        });
+    }
+
+    return combiner.result();
+}
+
+/**
+ * @brief Reduces blocks `begin` to `end` of the loop whose first element is
+ *        `data`, combining the block results pairwise. Compiled for each SIMD
+ *        level.
+ */
+template <typename Op, typename T>
+typename Op::accumulator reduce_blocks(Op const &op, T const *data, ReduceBlocks const &blocks,
+                                       index_t begin, index_t end)
+{
+    typename Op::accumulator result{};
+    simd_dispatch([&] { result = reduce_block_range(op, data, blocks, begin, end); });
+    return result;
+}
+
+/**
+ * @brief Reduces every element of the loop whose first element is `data`.
+ *        Blocks are reduced in fixed groups and the group results combined
+ *        pairwise, so the answer is the same whether or not the groups run
+ *        in parallel.
+ */
+template <typename Op, typename T>
+typename Op::accumulator reduce_all(Op const &op, T const *data, LoopLayout const &loop,
+                                    bool parallel)
+{
+    ReduceBlocks blocks(loop);
+    index_t num_groups = (blocks.count + reduce_group_size - 1)/reduce_group_size;
+
+    auto group = [&](index_t g) {
+        return reduce_blocks(op, data, blocks, g*reduce_group_size,
+                             std::min(blocks.count, (g+1)*reduce_group_size));
+    };
+
+    if (num_groups == 1) return group(0);
+
+    std::vector<typename Op::accumulator> partial(num_groups);
+    if (parallel) {
+        parallel_for(0, num_groups, 1, [&](index_t begin, index_t end) {
+            for (index_t g = begin; g < end; g++) partial[g] = group(g);
+        });
+    } else {
+        for (index_t g = 0; g < num_groups; g++) partial[g] = group(g);
+    }
+
+    PairwiseCombiner<Op> combiner(op);
+    for (auto const &value : partial) combiner.push(value);
+
+    return combiner.result();
+}
+
+/**
+ * @brief Reduces `num_rows` rows of `width` elements into `result`, where
+ *        row `r` starts at `data + row_offset(r)` and its elements are
+ *        `stride` apart. Rows are accumulated elementwise in blocks, and
+ *        block results combined as a balanced tree.
+ */
+template <typename Op, typename T, typename RowOffset>
+void reduce_rows(Op const &op, T const *data, index_t stride, index_t width,
+                 index_t begin, index_t end, RowOffset const &row_offset,
+                 typename Op::accumulator *result,
+                 std::vector<std::vector<typename Op::accumulator>> &scratch, std::size_t level)
+{
+    if (end - begin <= reduce_row_block) {
+        simd_dispatch([&] {
+            T const *row = data + row_offset(begin);
+            for (index_t j = 0; j < width; j++) {
+                result[j] = op.load(row[j*stride], begin);
+            }
+
+            for (index_t r = begin + 1; r < end; r++) {
+                row = data + row_offset(r);
+                for (index_t j = 0; j < width; j++) {
+                    result[j] = op.combine(result[j], op.load(row[j*stride], r));
+                }
+            }
+        });
+
+        return;
+    }
+
+    if (scratch.size() <= level) scratch.emplace_back();
+    if (scratch[level].size() < width) scratch[level].resize(width);
+    auto *rhs = scratch[level].data();
+
+    index_t middle = begin + (end - begin)/2;
+    reduce_rows(op, data, stride, width, begin, middle, row_offset, result, scratch, level+1);
+    reduce_rows(op, data, stride, width, middle, end, row_offset, rhs, scratch, level+1);
+
+    for (index_t j = 0; j < width; j++) {
+        result[j] = op.combine(result[j], rhs[j]);
+    }
+}
+
+/**
+ * @brief Reduces `t` over `axes` with `op`. The result has `t`'s shape with
+ *        the reduced dimensions set to 1.
+ *
+ * When the reduced dimensions include the one with the smallest stride, each
+ * output reduces runs of neighbouring elements. Otherwise whole rows of the
+ * kept inner dimension are accumulated at a time, so reducing over an outer
+ * dimension streams through memory instead of striding down columns.
+ */
+template <typename Op, typename T, typename Device>
+Tensor<typename Op::result_type, Device> reduce(Tensor<T, Device> const &t, indices const &axes, Op op) {
+    using R = typename Op::result_type;
+    using accumulator = typename Op::accumulator;
+
+    auto const &shape = t.shape();
+    auto dims = shape.size();
+
+    std::vector<bool> reduced(dims, false);
+    for (auto axis : axes) {
+        if (axis >= dims || reduced[axis]) throw InvalidAxes(axes, shape);
+        reduced[axis] = true;
+    }
+
+    extent result_shape = shape;
+    extent reduced_shape = shape;
+    for (std::size_t d = 0; d < dims; d++) {
+        (reduced[d] ? result_shape : reduced_shape)[d] = 1;
+    }
+
+    Tensor<R, Device> result(result_shape, uninitialized);
+    index_t count = ::num_elements(reduced_shape);
+    index_t outputs = ::num_elements(result_shape);
+    if (outputs == 0) return result;
+
+    R *result_data = result.data();
+    if (count == 0) {
+        if (!Op::has_identity) throw EmptyReduction(shape);
+        std::fill(result_data, result_data + outputs, op.finish(op.identity(), 0));
+        return result;
+    }
+
+    T const *data = t.data();
+    auto order = stride_order(t.strides());
+    auto kept = coalesce(result_shape, order, {t.strides(), result.strides()});
+    auto inner = coalesce(reduced_shape, order, {t.strides()});
+
+    index_t kept_size = kept.shape[0];
+    bool row_wise = outputs > 1 && count > 1 && kept_size >= reduce_row_block &&
+                    kept.strides[0][0] < inner.strides[0][0];
+
+    if (!row_wise) {
+        // few outputs: split each output's reduction across threads instead
+        if (outputs < num_threads()) {
+            for_each_span<2>(kept, {0, 0}, [&](auto const &offsets, index_t size) {
+                for (index_t j = 0; j < size; j++) {
+                    auto value = reduce_all(op, data + offsets[0] + j*kept.strides[0][0], inner, true);
+                    result_data[offsets[1] + j*kept.strides[1][0]] = op.finish(value, count);
+                }
+            });
+
+            return result;
+        }
+
+        parallel_for_each_span<2>(kept, grain_size_for(count), [&](auto const &offsets, index_t size) {
+            for (index_t j = 0; j < size; j++) {
+                auto value = reduce_all(op, data + offsets[0] + j*kept.strides[0][0], inner, false);
+                result_data[offsets[1] + j*kept.strides[1][0]] = op.finish(value, count);
+            }
+        });
+
+        return result;
+    }
+
+    // offset of the `r`th reduced position, in the order the loop visits them
+    auto row_offset = [&inner](index_t r) {
+        offset_t offset = 0;
+        for (std::size_t d = 0; d < inner.shape.size(); d++) {
+            offset += (r % inner.shape[d])*inner.strides[0][d];
+            r /= inner.shape[d];
+        }
+
+        return offset;
+    };
+
+    index_t spans = num_spans(kept);
+    index_t column_blocks = (kept_size + reduce_column_block - 1)/reduce_column_block;
+
+    parallel_for(0, spans*column_blocks, grain_size_for(count*reduce_column_block),
+        [&](index_t begin, index_t end) {
+            std::vector<accumulator> values(reduce_column_block);
+            std::vector<std::vector<accumulator>> scratch;
+
+            for (index_t item = begin; item < end; item++) {
+                index_t span = item/column_blocks;
+                index_t column = (item % column_blocks)*reduce_column_block;
+                index_t width = std::min(reduce_column_block, kept_size - column);
+
+                for_each_span<2>(kept, {0, 0}, span, span+1, [&](auto const &offsets, index_t) {
+                    reduce_rows(op, data + offsets[0] + column*kept.strides[0][0], kept.strides[0][0],
+                                width, 0, count, row_offset, values.data(), scratch, 0);
+
+                    R *out = result_data + offsets[1] + column*kept.strides[1][0];
+                    for (index_t j = 0; j < width; j++) {
+                        out[j*kept.strides[1][0]] = op.finish(values[j], count);
+                    }
+                });
+            }
+        });
+
+    return result;
+}
+
+template <typename Op, typename T, typename Device>
+Tensor<typename Op::result_type, Device> reduce(Tensor<T, Device> const &t, indices const &axes,
+                                                bool keepdims, Op op)
+{
+    auto result = reduce(t, axes, op);
+    if (keepdims) return result;
+
+    extent shape;
+    for (std::size_t d = 0; d < t.num_dims(); d++) {
+        if (std::find(axes.begin(), axes.end(), d) == axes.end()) shape.push_back(t.shape()[d]);
+    }
+
+    // reducing every dimension leaves a single element
+    if (shape.empty()) shape.push_back(1);
+
+    return reshape(result, shape);
+}
+
+template <typename T, typename Device>
+indices all_axes(Tensor<T, Device> const &t) {
+    indices axes(t.num_dims());
+    std::iota(axes.begin(), axes.end(), 0);
+    return axes;
+}
+
+// a one dimensional view of `t`'s elements in row-major order, copying `t`
+// unless it is already laid out that way
+template <typename T, typename Device>
+Tensor<T, Device> flatten_row_major(Tensor<T, Device> const &t) {
+    auto row_major = make_row_major_order(t.num_dims());
+    auto source = is_contiguous(View(t.shape(), row_major, t.strides())) ? t : copy(t);
+
+    return source.view(View({::num_elements(t.shape())}, {base_offset(source.view())}, {0}, {1}));
+}
+
+template <typename Op, typename T, typename Device>
+typename Op::result_type reduce_to_scalar(Tensor<T, Device> const &t, Op op) {
+    return *reduce(t, all_axes(t), op).data();
+}
+
+} // namespace detail
+
+/**
+ * @brief Sums `t` over `axes`. With `keepdims` the reduced dimensions are
+ *        kept with size 1, otherwise they are removed.
+ *
+ * Floating point sums are pairwise: blocks of neighbouring elements are
+ * summed in eight interleaved lanes and the block sums added as a balanced
+ * tree, so the rounding error grows with O(log n) rather than O(n). The
+ * order of additions is fixed by the tensor's layout alone, so results are
+ * identical for any number of threads.
+ */
+template <typename T, typename Device>
+Tensor<T, Device> sum(Tensor<T, Device> const &t, indices const &axes, bool keepdims=false) {
+    return detail::reduce(t, axes, keepdims, reduce_ops::Sum<T>());
+}
+
+template <typename T, typename Device>
+Tensor<T, Device> sum(Tensor<T, Device> const &t, index_t axis, bool keepdims=false) {
+    return sum(t, indices{axis}, keepdims);
+}
+
+/**
+ * @brief Sums every element of `t`
+ */
+template <typename T, typename Device>
+T sum(Tensor<T, Device> const &t) {
+    return detail::reduce_to_scalar(t, reduce_ops::Sum<T>());
+}
+
+/**
+ * @brief Averages `t` over `axes`, summing pairwise as `sum` does. Integer
+ *        tensors are averaged in double precision.
+ */
+template <typename T, typename Device>
+Tensor<reduce_ops::mean_type<T>, Device> mean(Tensor<T, Device> const &t, indices const &axes,
+                                              bool keepdims=false)
+{
+    return detail::reduce(t, axes, keepdims, reduce_ops::Mean<T>());
+}
+
+template <typename T, typename Device>
+Tensor<reduce_ops::mean_type<T>, Device> mean(Tensor<T, Device> const &t, index_t axis,
+                                              bool keepdims=false)
+{
+    return mean(t, indices{axis}, keepdims);
+}
+
+template <typename T, typename Device>
+reduce_ops::mean_type<T> mean(Tensor<T, Device> const &t) {
+    return detail::reduce_to_scalar(t, reduce_ops::Mean<T>());
+}
+
+/**
+ * @brief Multiplies `t` over `axes`
+ */
+template <typename T, typename Device>
+Tensor<T, Device> prod(Tensor<T, Device> const &t, indices const &axes, bool keepdims=false) {
+    return detail::reduce(t, axes, keepdims, reduce_ops::Prod<T>());
+}
+
+template <typename T, typename Device>
+Tensor<T, Device> prod(Tensor<T, Device> const &t, index_t axis, bool keepdims=false) {
+    return prod(t, indices{axis}, keepdims);
+}
+
+template <typename T, typename Device>
+T prod(Tensor<T, Device> const &t) {
+    return detail::reduce_to_scalar(t, reduce_ops::Prod<T>());
+}
+
+/**
+ * @brief Largest element of `t` over `axes`; NaNs propagate. Throws
+ *        `EmptyReduction` when reducing over an empty dimension.
+ */
+template <typename T, typename Device>
+Tensor<T, Device> max(Tensor<T, Device> const &t, indices const &axes, bool keepdims=false) {
+    return detail::reduce(t, axes, keepdims, reduce_ops::Max<T>());
+}
+
+template <typename T, typename Device>
+Tensor<T, Device> max(Tensor<T, Device> const &t, index_t axis, bool keepdims=false) {
+    return max(t, indices{axis}, keepdims);
+}
+
+template <typename T, typename Device>
+T max(Tensor<T, Device> const &t) {
+    return detail::reduce_to_scalar(t, reduce_ops::Max<T>());
+}
+
+/**
+ * @brief Smallest element of `t` over `axes`; NaNs propagate. Throws
+ *        `EmptyReduction` when reducing over an empty dimension.
+ */
+template <typename T, typename Device>
+Tensor<T, Device> min(Tensor<T, Device> const &t, indices const &axes, bool keepdims=false) {
+    return detail::reduce(t, axes, keepdims, reduce_ops::Min<T>());
+}
+
+template <typename T, typename Device>
+Tensor<T, Device> min(Tensor<T, Device> const &t, index_t axis, bool keepdims=false) {
+    return min(t, indices{axis}, keepdims);
+}
+
+template <typename T, typename Device>
+T min(Tensor<T, Device> const &t) {
+    return detail::reduce_to_scalar(t, reduce_ops::Min<T>());
+}
+
+/**
+ * @brief Position along `axis` of the largest element of `t`. Ties go to the
+ *        first occurrence, and a NaN counts as larger than any number.
+ */
+template <typename T, typename Device>
+Tensor<index_t, Device> argmax(Tensor<T, Device> const &t, index_t axis, bool keepdims=false) {
+    return detail::reduce(t, {axis}, keepdims, reduce_ops::ArgMax<T>());
+}
+
+/**
+ * @brief Row-major position of the largest element of `t`
+ */
+template <typename T, typename Device>
+index_t argmax(Tensor<T, Device> const &t) {
+    return *detail::reduce(detail::flatten_row_major(t), {0}, reduce_ops::ArgMax<T>()).data();
+}
+
+/**
+ * @brief Position along `axis` of the smallest element of `t`. Ties go to the
+ *        first occurrence, and a NaN counts as smaller than any number.
+ */
+template <typename T, typename Device>
+Tensor<index_t, Device> argmin(Tensor<T, Device> const &t, index_t axis, bool keepdims=false) {
+    return detail::reduce(t, {axis}, keepdims, reduce_ops::ArgMin<T>());
+}
+
+/**
+ * @brief Row-major position of the smallest element of `t`
+ */
+template <typename T, typename Device>
+index_t argmin(Tensor<T, Device> const &t) {
+    return *detail::reduce(detail::flatten_row_major(t), {0}, reduce_ops::ArgMin<T>()).data();
+}
+
+#endif
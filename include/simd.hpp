@@ -0,0 +1,162 @@
+#ifndef SIMD_HPP
+#define SIMD_HPP
+
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+
+/**
+ * @brief Instruction set levels the kernels are compiled for, in increasing
+ *        order. Each level includes the ones before it.
+ */
+enum class SimdLevel {
+    // whatever the build targets; SSE2 for x86-64
+    Generic,
+
+    SSE42,
+
+    // AVX2 with FMA
+    AVX2,
+
+    // AVX-512 F, VL, BW and DQ
+    AVX512
+};
+
+// Kernels are cloned for each level with GCC/Clang target attributes, which
+// only exist for x86. Elsewhere (or with TENSOR_NO_SIMD_DISPATCH defined)
+// everything runs at the Generic level.
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__) && \
+    !defined(TENSOR_NO_SIMD_DISPATCH)
+#define TENSOR_SIMD_DISPATCH
+#endif
+
+/**
+ * @brief Highest level supported by both the CPU and the operating system
+ */
+inline SimdLevel detect_simd_level() {
+#ifdef TENSOR_SIMD_DISPATCH
+    static SimdLevel detected = [] {
+        __builtin_cpu_init();
+
+        if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vl") &&
+            __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512dq"))
+        {
+            return SimdLevel::AVX512;
+        }
+
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+            return SimdLevel::AVX2;
+        }
+
+        if (__builtin_cpu_supports("sse4.2")) return SimdLevel::SSE42;
+
+        return SimdLevel::Generic;
+    }();
+
+    return detected;
+#else
+    return SimdLevel::Generic;
+#endif
+}
+
+/**
+ * @brief Reads a level named `generic`, `sse4.2`, `avx2` or `avx512` into
+ *        `level`; returns false if `name` is none of them
+ */
+inline bool parse_simd_level(std::string const &name, SimdLevel &level) {
+    if (name == "generic") {
+        level = SimdLevel::Generic;
+    } else if (name == "sse4.2") {
+        level = SimdLevel::SSE42;
+    } else if (name == "avx2") {
+        level = SimdLevel::AVX2;
+    } else if (name == "avx512") {
+        level = SimdLevel::AVX512;
+    } else {
+        return false;
+    }
+
+    return true;
+}
+
+namespace detail {
+
+inline SimdLevel &simd_level_setting() {
+    static SimdLevel level = [] {
+        SimdLevel forced;
+        if (auto env = std::getenv("TENSOR_SIMD_LEVEL")) {
+            if (parse_simd_level(env, forced)) return std::min(forced, detect_simd_level());
+        }
+
+        return detect_simd_level();
+    }();
+
+    return level;
+}
+
+} // namespace detail
+
+/**
+ * @brief Level the kernels dispatch to: the detected one, or the level named
+ *        by `TENSOR_SIMD_LEVEL` if that is lower
+ */
+inline SimdLevel simd_level() {
+    return detail::simd_level_setting();
+}
+
+/**
+ * @brief Makes the kernels dispatch to `level`, capped at what the CPU
+ *        supports. Returns the level now in effect.
+ */
+inline SimdLevel set_simd_level(SimdLevel level) {
+    return detail::simd_level_setting() = std::min(level, detect_simd_level());
+}
+
+namespace detail {
+
+#ifdef TENSOR_SIMD_DISPATCH
+// `flatten` inlines everything `fn` calls, so the whole kernel is compiled
+// for the clone's target
+template <typename F>
+__attribute__((target("sse4.2"), flatten))
+void run_sse42(F const &fn) { fn(); }
+
+template <typename F>
+__attribute__((target("avx2,fma"), flatten))
+void run_avx2(F const &fn) { fn(); }
+
+template <typename F>
+__attribute__((target("avx512f,avx512vl,avx512bw,avx512dq,avx2,fma"), flatten))
+void run_avx512(F const &fn) { fn(); }
+#endif
+
+} // namespace detail
+
+/**
+ * @brief Runs `fn()` compiled for the current `simd_level()`.
+ *
+ * `fn` should be a leaf kernel (a loop over a chunk of data) since all of it
+ * is inlined into each clone; calls into the thread pool belong outside.
+ */
+template <typename F>
+void simd_dispatch(F const &fn) {
+#ifdef TENSOR_SIMD_DISPATCH
+    switch (simd_level()) {
+    case SimdLevel::AVX512:
+        detail::run_avx512(fn);
+        return;
+    case SimdLevel::AVX2:
+        detail::run_avx2(fn);
+        return;
+    case SimdLevel::SSE42:
+        detail::run_sse42(fn);
+        return;
+    default:
+        break;
+    }
+#endif
+
+    fn();
+}
+
+#endif
@@ -1,6 +1,7 @@
 #ifndef SLICE_HPP
 #define SLICE_HPP
 
+#include <memory>
 #include <utility>
 
 #include <range/v3/all.hpp>
@@ -10,38 +11,84 @@
 
 using index_range_t = std::pair<std::size_t, std::size_t>;
 
+/**
+ * @brief Part of a Tensor, as returned by `operator[]`.
+ *
+ * Slicing an lvalue gives a Slice that borrows its parent's storage handle
+ * without sharing ownership of it, so taking and chaining slices
+ * (`a[i][j][k]`) never touches the storage's reference count. Such a Slice
+ * must not outlive its parent, nor be used after the parent is moved from or
+ * reassigned; convert it to a `Tensor` to keep it around. Slicing an rvalue
+ * (a temporary, or `std::move(t)`) gives a Slice that owns the handle
+ * instead, so it stays valid on its own.
+ */
 template <typename T, typename D>
 class Slice {
 public:
     using NumericType = T;
     using Device = D;
 
-    Slice(index_t dim_index,
-          index_t index,
-          View const &view,
-          std::shared_ptr<Storage<T, Device>> storage):
-            dim_index_(dim_index), view_(view), storage_(storage)
+    using StoragePtr = std::shared_ptr<Storage<T, Device>>;
+
+    Slice(index_t dim_index, index_t index, View const &view, StoragePtr const &storage):
+        Slice(dim_index, view, &storage, nullptr)
     {
-        view_.shape[dim_index] = 1;
-        view_.offset[dim_index_] = index + view.offset[dim_index_];
+        select(index, view);
     }
 
-    Slice(index_t dim_index,
-          index_range_t index_range,
-          View const &view,
-          std::shared_ptr<Storage<T, Device>> storage):
-            dim_index_(dim_index), view_(view), storage_(storage)
+    Slice(index_t dim_index, index_t index, View const &view, StoragePtr &&storage):
+        Slice(dim_index, view, nullptr, std::move(storage))
     {
-        view_.shape[dim_index] = index_range.second - index_range.first;
-        view_.offset[dim_index_] = index_range.first;
+        select(index, view);
+    }
+
+    Slice(index_t dim_index, index_range_t index_range, View const &view,
+          StoragePtr const &storage):
+        Slice(dim_index, view, &storage, nullptr)
+    {
+        select(index_range, view);
+    }
+
+    Slice(index_t dim_index, index_range_t index_range, View const &view,
+          StoragePtr &&storage):
+        Slice(dim_index, view, nullptr, std::move(storage))
+    {
+        select(index_range, view);
+    }
+
+    Slice(Slice const &slice):
+        dim_index_(slice.dim_index_), view_(slice.view_), owned_(slice.owned_),
+        storage_(slice.owns_storage() ? &owned_ : slice.storage_) {}
+
+    Slice(Slice &&slice) noexcept:
+        dim_index_(slice.dim_index_), view_(std::move(slice.view_)),
+        owned_(std::move(slice.owned_)),
+        storage_(slice.owns_storage() ? &owned_ : slice.storage_) {}
+
+    Slice &operator =(Slice slice) {
+        dim_index_ = slice.dim_index_;
+        view_ = std::move(slice.view_);
+        owned_ = std::move(slice.owned_);
+        storage_ = slice.owns_storage() ? &owned_ : slice.storage_;
+        return *this;
+    }
+
+    Slice<T, Device> operator [](index_t index) const & {
+        return Slice(dim_index_+1, index, view_, *storage_);
+    }
+
+    Slice<T, Device> operator [](index_t index) && {
+        if (owns_storage()) return Slice(dim_index_+1, index, view_, std::move(owned_));
+        return Slice(dim_index_+1, index, view_, *storage_);
     }
 
-    Slice<T, Device> operator [](index_t index) const {
-        return Slice(dim_index_+1, index, view_, storage_);
+    Slice<T, Device> operator [](index_range_t index_range) const & {
+        return Slice(dim_index_+1, index_range, view_, *storage_);
     }
 
-    Slice<T, Device> operator [](index_range_t index_range) const {
-        return Slice(dim_index_+1, index_range, view_, storage_);
+    Slice<T, Device> operator [](index_range_t index_range) && {
+        if (owns_storage()) return Slice(dim_index_+1, index_range, view_, std::move(owned_));
+        return Slice(dim_index_+1, index_range, view_, *storage_);
     }
 
     View const &view() const { return view_; }
@@ -50,16 +97,44 @@ public:
     extent const &shape() const { return view_.shape; }
     index_t shape(index_t dim) const { return view_.shape[dim]; }
 
-    Storage<T, Device> const &storage() const { return *storage_; }
-    std::shared_ptr<Storage<T, Device>> storage_ptr() const { return storage_; }
+    Storage<T, Device> const &storage() const { return **storage_; }
+
+    /**
+     * @brief The storage handle. Copying it is what makes a Tensor built
+     *        from this Slice an owner of the storage.
+     */
+    StoragePtr const &storage_ptr() const { return *storage_; }
 
     // TODO: rename dim_index, confusing otherwise
     index_t index() const { return dim_index_; }
     index_t num_dims() const { return view_.shape.size(); }
 private:
+    Slice(index_t dim_index, View const &view, StoragePtr const *borrowed, StoragePtr owned):
+        dim_index_(dim_index), view_(view), owned_(std::move(owned)),
+        storage_(borrowed ? borrowed : &owned_) {}
+
+    bool owns_storage() const { return storage_ == &owned_; }
+
+    void select(index_t index, View const &view) {
+        view_.shape[dim_index_] = 1;
+        view_.offset[dim_index_] = index + view.offset[dim_index_];
+        view_.base += index*view_.strides[dim_index_];
+    }
+
+    void select(index_range_t index_range, View const &view) {
+        view_.shape[dim_index_] = index_range.second - index_range.first;
+        view_.offset[dim_index_] = index_range.first + view.offset[dim_index_];
+        view_.base += index_range.first*view_.strides[dim_index_];
+    }
+
     index_t dim_index_;
     View view_;
-    std::shared_ptr<Storage<T, Device>> storage_;
+
+    // set when this Slice was taken from an rvalue
+    StoragePtr owned_;
+
+    // either the parent's handle or `owned_`
+    StoragePtr const *storage_;
 };
 
 #endif
\ No newline at end of file
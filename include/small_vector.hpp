@@ -0,0 +1,262 @@
+#ifndef SMALL_VECTOR_HPP
+#define SMALL_VECTOR_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+
+/**
+ * @brief Vector that keeps up to `N` elements inline and only allocates once
+ *        it grows past that.
+ *
+ * Used for shapes, strides and offsets, which almost never have more than a
+ * handful of dimensions, so copying a `View` doesn't allocate. Supports the
+ * subset of the `std::vector` interface the library uses. Only trivially
+ * copyable element types are supported, which lets elements be moved around
+ * as raw memory.
+ *
+ * @tparam T Element type
+ * @tparam N Number of elements stored inline
+ */
+template <typename T, std::size_t N>
+class small_vector {
+public:
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "small_vector only holds trivially copyable types");
+
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T &;
+    using const_reference = T const &;
+    using pointer = T *;
+    using const_pointer = T const *;
+    using iterator = T *;
+    using const_iterator = T const *;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    small_vector() = default;
+
+    explicit small_vector(size_type count) { resize(count); }
+
+    small_vector(size_type count, T const &value) { resize(count, value); }
+
+    template <typename InputIt,
+              typename = typename std::iterator_traits<InputIt>::iterator_category>
+    small_vector(InputIt first, InputIt last) { assign(first, last); }
+
+    small_vector(std::initializer_list<T> values) { assign(values.begin(), values.end()); }
+
+    small_vector(small_vector const &other) { assign(other.begin(), other.end()); }
+
+    small_vector(small_vector &&other) noexcept { steal(other); }
+
+    ~small_vector() { release(); }
+
+    small_vector &operator =(small_vector const &other) {
+        if (this != &other) assign(other.begin(), other.end());
+        return *this;
+    }
+
+    small_vector &operator =(small_vector &&other) noexcept {
+        if (this != &other) {
+            release();
+            steal(other);
+        }
+        return *this;
+    }
+
+    small_vector &operator =(std::initializer_list<T> values) {
+        assign(values.begin(), values.end());
+        return *this;
+    }
+
+    template <typename InputIt>
+    void assign(InputIt first, InputIt last) {
+        clear();
+        for (; first != last; ++first) push_back(static_cast<T>(*first));
+    }
+
+    void assign(size_type count, T const &value) {
+        clear();
+        resize(count, value);
+    }
+
+    T &operator [](size_type i) { return data_[i]; }
+    T const &operator [](size_type i) const { return data_[i]; }
+
+    T &at(size_type i) {
+        if (i >= size_) throw std::out_of_range("small_vector::at");
+        return data_[i];
+    }
+
+    T const &at(size_type i) const {
+        if (i >= size_) throw std::out_of_range("small_vector::at");
+        return data_[i];
+    }
+
+    T &front() { return data_[0]; }
+    T const &front() const { return data_[0]; }
+    T &back() { return data_[size_ - 1]; }
+    T const &back() const { return data_[size_ - 1]; }
+
+    T *data() { return data_; }
+    T const *data() const { return data_; }
+
+    iterator begin() { return data_; }
+    iterator end() { return data_ + size_; }
+    const_iterator begin() const { return data_; }
+    const_iterator end() const { return data_ + size_; }
+    const_iterator cbegin() const { return data_; }
+    const_iterator cend() const { return data_ + size_; }
+
+    reverse_iterator rbegin() { return reverse_iterator(end()); }
+    reverse_iterator rend() { return reverse_iterator(begin()); }
+    const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+    const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+    bool empty() const { return size_ == 0; }
+    size_type size() const { return size_; }
+    size_type capacity() const { return capacity_; }
+
+    void reserve(size_type capacity) {
+        if (capacity <= capacity_) return;
+
+        T *data = new T[capacity];
+        std::copy(begin(), end(), data);
+        if (!is_inline()) delete[] data_;
+
+        data_ = data;
+        capacity_ = capacity;
+    }
+
+    void clear() { size_ = 0; }
+
+    void resize(size_type count) { resize(count, T()); }
+
+    void resize(size_type count, T const &value) {
+        if (count > size_) {
+            if (count > capacity_) reserve(std::max(count, 2*capacity_));
+            std::fill(data_ + size_, data_ + count, value);
+        }
+        size_ = count;
+    }
+
+    void push_back(T const &value) {
+        if (size_ == capacity_) {
+            // `value` may refer to an element about to be moved
+            T copy = value;
+            reserve(2*capacity_);
+            data_[size_++] = copy;
+        } else {
+            data_[size_++] = value;
+        }
+    }
+
+    template <typename... Args>
+    T &emplace_back(Args &&... args) {
+        push_back(T(std::forward<Args>(args)...));
+        return back();
+    }
+
+    void pop_back() { --size_; }
+
+    iterator insert(const_iterator pos, T const &value) {
+        return insert(pos, size_type(1), value);
+    }
+
+    iterator insert(const_iterator pos, size_type count, T const &value) {
+        auto i = pos - begin();
+        T copy = value;
+
+        resize(size_ + count);
+        std::copy_backward(begin() + i, end() - count, end());
+        std::fill(begin() + i, begin() + i + count, copy);
+        return begin() + i;
+    }
+
+    template <typename InputIt,
+              typename = typename std::iterator_traits<InputIt>::iterator_category>
+    iterator insert(const_iterator pos, InputIt first, InputIt last) {
+        auto i = pos - begin();
+        small_vector values(first, last);
+
+        resize(size_ + values.size());
+        std::copy_backward(begin() + i, end() - values.size(), end());
+        std::copy(values.begin(), values.end(), begin() + i);
+        return begin() + i;
+    }
+
+    iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+
+    iterator erase(const_iterator first, const_iterator last) {
+        auto i = first - begin();
+        auto j = last - begin();
+
+        std::copy(begin() + j, end(), begin() + i);
+        size_ -= j - i;
+        return begin() + i;
+    }
+
+    void swap(small_vector &other) {
+        small_vector tmp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(tmp);
+    }
+private:
+    bool is_inline() const { return data_ == inline_; }
+
+    void release() {
+        if (!is_inline()) delete[] data_;
+        data_ = inline_;
+        size_ = 0;
+        capacity_ = N;
+    }
+
+    // leaves `other` empty
+    void steal(small_vector &other) {
+        if (other.is_inline()) {
+            std::copy(other.begin(), other.end(), inline_);
+        } else {
+            data_ = other.data_;
+            capacity_ = other.capacity_;
+            other.data_ = other.inline_;
+            other.capacity_ = N;
+        }
+
+        size_ = other.size_;
+        other.size_ = 0;
+    }
+
+    T inline_[N];
+    T *data_ = inline_;
+    size_type size_ = 0;
+    size_type capacity_ = N;
+};
+
+template <typename T, std::size_t N>
+bool operator ==(small_vector<T, N> const &lhs, small_vector<T, N> const &rhs) {
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <typename T, std::size_t N>
+bool operator !=(small_vector<T, N> const &lhs, small_vector<T, N> const &rhs) {
+    return !(lhs == rhs);
+}
+
+template <typename T, std::size_t N>
+bool operator <(small_vector<T, N> const &lhs, small_vector<T, N> const &rhs) {
+    return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <typename T, std::size_t N>
+void swap(small_vector<T, N> &lhs, small_vector<T, N> &rhs) {
+    lhs.swap(rhs);
+}
+
+#endif
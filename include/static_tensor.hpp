@@ -0,0 +1,363 @@
+#ifndef STATIC_TENSOR_HPP
+#define STATIC_TENSOR_HPP
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+#include "tensor.hpp"
+#include "tensor_ops.hpp"
+
+/**
+ * Tensors whose rank, or whole shape, is known at compile time. Their layout
+ * lives in `std::array`s instead of the `std::vector`s of a `View`, so
+ * creating one allocates no metadata and indexing is an unrolled sum of
+ * products:
+ *
+ * - `RankedTensor<T, Rank>` has a fixed rank and runtime extents, and shares
+ *   storage with `Tensor` (e.g. an `N x 3` point cloud).
+ * - `StaticTensor<T, Dims...>` has a fixed shape and holds its elements
+ *   inline, so it never touches the heap (e.g. a `3 x 3` rotation).
+ */
+
+struct MismatchedRank: public TensorError {
+    MismatchedRank(std::size_t rank, extent const &shape):
+        TensorError(fmt::format("Expected a tensor of rank {}: {}", rank, shape)) {}
+};
+
+namespace detail {
+
+template <std::size_t Rank>
+constexpr std::array<index_t, Rank> row_major_strides(std::array<index_t, Rank> const &shape) {
+    std::array<index_t, Rank> strides{};
+
+    index_t stride = 1;
+    for (std::size_t d = Rank; d-- > 0;) {
+        strides[d] = stride;
+        stride *= shape[d];
+    }
+
+    return strides;
+}
+
+// sum of `index[d]*strides[d]`, unrolled
+template <std::size_t Rank, std::size_t... D, typename... Args>
+constexpr offset_t static_offset(std::array<index_t, Rank> const &strides,
+                                 std::index_sequence<D...>, Args... index)
+{
+    return ((static_cast<index_t>(index)*strides[D]) + ... + 0);
+}
+
+template <std::size_t Rank>
+std::size_t num_elements(std::array<index_t, Rank> const &shape) {
+    std::size_t count = 1;
+    for (auto dim : shape) count *= dim;
+    return count;
+}
+
+template <typename Array>
+extent to_extent(Array const &array) {
+    return extent(array.begin(), array.end());
+}
+
+} // namespace detail
+
+/**
+ * @brief Tensor of rank `Rank` sharing storage with `Tensor`.
+ *
+ * Converting from a `Tensor` of the same rank, and back with `tensor()`, is
+ * free: both refer to the same elements.
+ *
+ * @tparam T Element type
+ * @tparam Rank Number of dimensions
+ * @tparam Device Device storage lives on
+ */
+template <typename T, std::size_t Rank, typename Device=CPU>
+class RankedTensor {
+public:
+    static_assert(Rank > 0, "a RankedTensor needs at least one dimension");
+
+    using NumericType = T;
+    using shape_type = std::array<index_t, Rank>;
+
+    static constexpr std::size_t rank = Rank;
+
+    /**
+     * @brief Allocates a zero-initialized, row-major tensor of `shape`
+     */
+    explicit RankedTensor(shape_type const &shape):
+        RankedTensor(shape, std::make_shared<Storage<T, Device>>(detail::num_elements(shape))) {}
+
+    /**
+     * @brief Allocates a row-major tensor of `shape`, leaving its elements
+     *        uninitialized
+     */
+    RankedTensor(shape_type const &shape, uninitialized_t):
+        RankedTensor(shape, std::make_shared<Storage<T, Device>>(detail::num_elements(shape),
+                                                                 uninitialized)) {}
+
+    /**
+     * @brief Refers to the elements of `t`, which must have rank `Rank`
+     */
+    explicit RankedTensor(Tensor<T, Device> const &t):
+        storage_(t.storage_ptr())
+    {
+        if (t.num_dims() != Rank) throw MismatchedRank(Rank, t.shape());
+
+        auto const &view = t.view();
+        std::copy(view.shape.begin(), view.shape.end(), shape_.begin());
+        std::copy(view.strides.begin(), view.strides.end(), strides_.begin());
+        data_ = t.data();
+    }
+
+    /**
+     * @brief Returns a `Tensor` referring to the same elements
+     */
+    Tensor<T, Device> tensor() const {
+        indices strides(strides_.begin(), strides_.end());
+        View view(detail::to_extent(shape_), stride_order(strides), strides);
+        view.base = data_ - storage_->data();
+        return Tensor<T, Device>(storage_, view);
+    }
+
+    template <typename... Args>
+    T &operator ()(Args... index) const {
+        static_assert(sizeof...(Args) == Rank, "wrong number of indices");
+        return data_[detail::static_offset(strides_, std::index_sequence_for<Args...>{}, index...)];
+    }
+
+    shape_type const &shape() const { return shape_; }
+    index_t shape(std::size_t dim) const { return shape_[dim]; }
+
+    shape_type const &strides() const { return strides_; }
+
+    std::size_t num_dims() const { return Rank; }
+    std::size_t num_elements() const { return detail::num_elements(shape_); }
+
+    /**
+     * @brief Pointer to element `(0, ..., 0)`
+     */
+    T *data() const { return data_; }
+
+    std::shared_ptr<Storage<T, Device>> const &storage_ptr() const { return storage_; }
+private:
+    RankedTensor(shape_type const &shape, std::shared_ptr<Storage<T, Device>> storage):
+        shape_(shape),
+        strides_(detail::row_major_strides(shape)),
+        storage_(std::move(storage)),
+        data_(storage_->data()) {}
+
+    shape_type shape_;
+    shape_type strides_;
+
+    std::shared_ptr<Storage<T, Device>> storage_;
+    T *data_;
+};
+
+template <typename T, std::size_t Rank, typename Device>
+index_t num_elements(RankedTensor<T, Rank, Device> const &t) {
+    return t.num_elements();
+}
+
+/**
+ * @brief Row-major tensor of shape `Dims...` holding its elements inline.
+ *
+ * A value type: copying one copies its elements. Shape, strides and size are
+ * compile-time constants, so indexing compiles down to a constant offset
+ * when the indices are constants too.
+ *
+ * @tparam T Element type
+ * @tparam Dims Extent of each dimension
+ */
+template <typename T, index_t... Dims>
+class StaticTensor {
+public:
+    static_assert(sizeof...(Dims) > 0, "a StaticTensor needs at least one dimension");
+
+    using NumericType = T;
+    using shape_type = std::array<index_t, sizeof...(Dims)>;
+
+    static constexpr std::size_t rank = sizeof...(Dims);
+    static constexpr std::size_t size = (Dims * ...);
+    static constexpr shape_type static_shape = {Dims...};
+    static constexpr shape_type static_strides = detail::row_major_strides(static_shape);
+
+    /**
+     * @brief All elements set to zero
+     */
+    constexpr StaticTensor(): values_{} {}
+
+    /**
+     * @brief Elements in row-major order, e.g. `StaticTensor<int, 2, 2>({1, 2, 3, 4})`
+     */
+    constexpr StaticTensor(std::array<T, size> const &values): values_(values) {}
+
+    /**
+     * @brief Copies the elements of `t`, which must have shape `Dims...`
+     */
+    template <typename Device>
+    explicit StaticTensor(Tensor<T, Device> const &t) {
+        if (t.shape() != detail::to_extent(static_shape)) {
+            throw MismatchedDimensions(detail::to_extent(static_shape), t.shape());
+        }
+
+        auto view = from_buffer<T, Device>(values_.data(), t.shape());
+        assign(view, t);
+    }
+
+    /**
+     * @brief Copies the elements into a new `Tensor`
+     */
+    template <typename Device=CPU>
+    Tensor<T, Device> tensor() const {
+        Tensor<T, Device> result(detail::to_extent(static_shape), uninitialized);
+        std::copy(values_.begin(), values_.end(), result.data());
+        return result;
+    }
+
+    template <typename... Args>
+    constexpr T &operator ()(Args... index) {
+        static_assert(sizeof...(Args) == rank, "wrong number of indices");
+        return values_[detail::static_offset(static_strides, std::index_sequence_for<Args...>{},
+                                             index...)];
+    }
+
+    template <typename... Args>
+    constexpr T const &operator ()(Args... index) const {
+        static_assert(sizeof...(Args) == rank, "wrong number of indices");
+        return values_[detail::static_offset(static_strides, std::index_sequence_for<Args...>{},
+                                             index...)];
+    }
+
+    static constexpr shape_type shape() { return static_shape; }
+    static constexpr index_t shape(std::size_t dim) { return static_shape[dim]; }
+    static constexpr shape_type strides() { return static_strides; }
+    static constexpr std::size_t num_dims() { return rank; }
+    static constexpr std::size_t num_elements() { return size; }
+
+    constexpr T *data() { return values_.data(); }
+    constexpr T const *data() const { return values_.data(); }
+
+    constexpr T *begin() { return values_.data(); }
+    constexpr T *end() { return values_.data() + size; }
+    constexpr T const *begin() const { return values_.data(); }
+    constexpr T const *end() const { return values_.data() + size; }
+
+    constexpr StaticTensor &operator +=(StaticTensor const &rhs) {
+        for (std::size_t i = 0; i < size; i++) values_[i] += rhs.values_[i];
+        return *this;
+    }
+
+    constexpr StaticTensor &operator -=(StaticTensor const &rhs) {
+        for (std::size_t i = 0; i < size; i++) values_[i] -= rhs.values_[i];
+        return *this;
+    }
+
+    constexpr StaticTensor &operator *=(T scale) {
+        for (auto &value : values_) value *= scale;
+        return *this;
+    }
+
+    constexpr bool operator ==(StaticTensor const &rhs) const {
+        for (std::size_t i = 0; i < size; i++) {
+            if (!(values_[i] == rhs.values_[i])) return false;
+        }
+        return true;
+    }
+
+    constexpr bool operator !=(StaticTensor const &rhs) const { return !(*this == rhs); }
+private:
+    template <typename Device>
+    static void assign(Tensor<T, Device> &to, Tensor<T, Device> const &from) {
+        iapply(to, from, [](T, T value) { return value; });
+    }
+
+    std::array<T, size> values_;
+};
+
+template <typename T, index_t... Dims>
+constexpr StaticTensor<T, Dims...> operator +(StaticTensor<T, Dims...> lhs,
+                                              StaticTensor<T, Dims...> const &rhs)
+{
+    return lhs += rhs;
+}
+
+template <typename T, index_t... Dims>
+constexpr StaticTensor<T, Dims...> operator -(StaticTensor<T, Dims...> lhs,
+                                              StaticTensor<T, Dims...> const &rhs)
+{
+    return lhs -= rhs;
+}
+
+template <typename T, index_t... Dims>
+constexpr StaticTensor<T, Dims...> operator *(T scale, StaticTensor<T, Dims...> t) {
+    return t *= scale;
+}
+
+template <typename T, index_t... Dims>
+constexpr StaticTensor<T, Dims...> operator *(StaticTensor<T, Dims...> t, T scale) {
+    return t *= scale;
+}
+
+/**
+ * @brief Matrix product of an `M x K` and a `K x N` static tensor
+ */
+template <typename T, index_t M, index_t K, index_t N>
+constexpr StaticTensor<T, M, N> product(StaticTensor<T, M, K> const &lhs,
+                                        StaticTensor<T, K, N> const &rhs)
+{
+    StaticTensor<T, M, N> result;
+    for (index_t i = 0; i < M; i++) {
+        for (index_t p = 0; p < K; p++) {
+            for (index_t j = 0; j < N; j++) {
+                result(i, j) += lhs(i, p)*rhs(p, j);
+            }
+        }
+    }
+
+    return result;
+}
+
+/**
+ * @brief Product of an `M x K` static matrix and a `K` static vector
+ */
+template <typename T, index_t M, index_t K>
+constexpr StaticTensor<T, M> product(StaticTensor<T, M, K> const &lhs,
+                                     StaticTensor<T, K> const &rhs)
+{
+    StaticTensor<T, M> result;
+    for (index_t i = 0; i < M; i++) {
+        for (index_t p = 0; p < K; p++) {
+            result(i) += lhs(i, p)*rhs(p);
+        }
+    }
+
+    return result;
+}
+
+template <typename T, index_t M, index_t K, index_t N>
+constexpr StaticTensor<T, M, N> operator *(StaticTensor<T, M, K> const &lhs,
+                                           StaticTensor<T, K, N> const &rhs)
+{
+    return product(lhs, rhs);
+}
+
+template <typename T, index_t M, index_t K>
+constexpr StaticTensor<T, M> operator *(StaticTensor<T, M, K> const &lhs,
+                                        StaticTensor<T, K> const &rhs)
+{
+    return product(lhs, rhs);
+}
+
+template <typename T, index_t M, index_t N>
+constexpr StaticTensor<T, N, M> transpose(StaticTensor<T, M, N> const &t) {
+    StaticTensor<T, N, M> result;
+    for (index_t i = 0; i < M; i++) {
+        for (index_t j = 0; j < N; j++) result(j, i) = t(i, j);
+    }
+
+    return result;
+}
+
+#endif
@@ -1,8 +1,11 @@
 #ifndef STORAGE_HPP
 #define STORAGE_HPP
 
+#include <memory>
+#include <type_traits>
 #include <vector>
 
+#include "allocator.hpp"
 #include "types.hpp"
 
 // namespace tensor {
@@ -11,6 +14,13 @@ struct CPU {};
 struct CPU_BLAS {};
 struct GPU_CUDA {};
 
+/**
+ * @brief Tag requesting storage whose elements are left uninitialized, for
+ *        tensors that are about to be completely overwritten
+ */
+struct uninitialized_t {};
+constexpr uninitialized_t uninitialized{};
+
 /**
  * @brief Storage type for `Tensor`s.
  *
@@ -21,30 +31,101 @@ template <typename T, typename Device>
 struct Storage {};
 
 /**
- * @brief CPU specialization of `Storage`
+ * @brief CPU specialization of `Storage`.
+ *
+ * Storage either owns its elements, which are aligned to
+ * `TENSOR_STORAGE_ALIGNMENT` bytes and allocated from `caching_allocator()`,
+ * or refers to memory owned by something else (such as a memory-mapped
+ * file), which it keeps alive through a shared `owner` handle.
  *
  * @tparam T Element type of storage
  */
 template <typename T>
 struct Storage<T, CPU> {
     using element_type = T;
-    using storage_type = std::vector<element_type>;
-    using iterator = typename storage_type::iterator;
+    using storage_type = std::vector<element_type, PoolAllocator<element_type>>;
+    using iterator = T *;
+    using const_iterator = T const *;
+
+    /**
+     * @brief Allocates `size` zero-initialized elements
+     */
+    Storage(std::size_t size):
+        owned_(size, 0), data_(owned_.data()), size_(size) {}
+
+    /**
+     * @brief Allocates `size` elements without initializing them
+     */
+    Storage(std::size_t size, uninitialized_t):
+        owned_(size), data_(owned_.data()), size_(size) {}
+
+    /**
+     * @brief Refers to `size` elements at `data` without copying them
+     *
+     * @param owner Handle keeping `data` valid; released (possibly freeing
+     *              `data`) when the storage is destroyed
+     */
+    Storage(T *data, std::size_t size, std::shared_ptr<void> owner):
+        data_(data), size_(size), owner_(std::move(owner)) {}
+
+    /**
+     * @brief Refers to `size` elements at `data`, calling `deleter(data)`
+     *        once the storage is destroyed
+     */
+    template <typename Deleter,
+              typename = std::enable_if_t<std::is_invocable_v<Deleter &, T *>>>
+    Storage(T *data, std::size_t size, Deleter deleter):
+        Storage(data, size, std::shared_ptr<void>(data, std::move(deleter))) {}
+
+    /**
+     * @brief Refers to `size` elements at `data` without taking ownership;
+     *        `data` must outlive the storage
+     */
+    Storage(T *data, std::size_t size):
+        data_(data), size_(size) {}
 
-    Storage(std::size_t size): data(size, 0) {}
+    // tensors share storage through pointers; `data_` may point into `owned_`
+    Storage(Storage const &) = delete;
+    Storage &operator =(Storage const &) = delete;
 
-    T &operator [](index_t i) { return data[i]; }
-    const T &operator [](index_t i) const { return data[i]; }
+    T &operator [](index_t i) { return data_[i]; }
+    const T &operator [](index_t i) const { return data_[i]; }
 
-    auto begin() { return data.begin(); }
-    auto end() { return data.end(); }
+    T *data() { return data_; }
+    T const *data() const { return data_; }
 
-    auto cbegin() const { return data.cbegin(); }
-    auto cend() const { return data.cend(); }
+    iterator begin() { return data_; }
+    iterator end() { return data_ + size_; }
 
-    std::size_t size() const { return data.size(); }
+    const_iterator begin() const { return data_; }
+    const_iterator end() const { return data_ + size_; }
 
-    std::vector<T> data;
+    const_iterator cbegin() const { return data_; }
+    const_iterator cend() const { return data_ + size_; }
+
+    std::size_t size() const { return size_; }
+
+    /**
+     * @brief Handle keeping externally owned elements alive (null if the
+     *        storage owns its elements, or does not manage them at all)
+     */
+    std::shared_ptr<void> const &owner() const { return owner_; }
+private:
+    storage_type owned_;
+    T *data_;
+    std::size_t size_;
+    std::shared_ptr<void> owner_;
+};
+
+/**
+ * @brief CPU_BLAS specialization of `Storage`. Identical to `CPU`; the device
+ *        only changes which kernels the matrix products use.
+ *
+ * @tparam T Element type of storage
+ */
+template <typename T>
+struct Storage<T, CPU_BLAS>: public Storage<T, CPU> {
+    using Storage<T, CPU>::Storage;
 };
 
 #endif
\ No newline at end of file
@@ -1,6 +1,8 @@
 #ifndef STRIDE_GENERATOR_HPP
 #define STRIDE_GENERATOR_HPP
 
+#include <numeric>
+
 #include <range/v3/all.hpp>
 
 #include "types.hpp"
@@ -66,12 +68,14 @@ inline indices make_strides(extent const &shape, const indices &order) {
 }
 
 inline indices make_row_major_order(std::size_t num_dims) {
-    indices result = ranges::view::iota(0) | ranges::view::take(num_dims) | ranges::view::reverse;
+    indices result(num_dims);
+    std::iota(result.rbegin(), result.rend(), 0);
     return result;
 }
 
 inline indices make_col_major_order(std::size_t num_dims) {
-    indices result = ranges::view::iota(0) | ranges::view::take(num_dims);
+    indices result(num_dims);
+    std::iota(result.begin(), result.end(), 0);
     return result;
 }
 
@@ -1,14 +1,15 @@
 #ifndef TENSOR_HPP
 #define TENSOR_HPP
 
+#include <array>
 #include <vector>
 #include <memory>
 #include <numeric>
 #include <functional>
 #include <iostream>
 #include <list>
+#include <stdexcept>
 #include <type_traits>
-#include <tuple>
 
 #include <fmt/core.h>
 #include <fmt/format.h>
@@ -19,7 +20,9 @@
 #include "stride_generator.hpp"
 #include "storage.hpp"
 #include "layout.hpp"
+#include "profile.hpp"
 #include "slice.hpp"
+#include "expression.hpp"
 
 enum class TensorOrder {
     RowMajor,
@@ -34,17 +37,6 @@ inline indices make_order(std::size_t dims, TensorOrder order) {
     }
 }
 
-template <typename T, typename... Args>
-constexpr std::array<T, sizeof...(Args)> tuple_to_array(std::tuple<Args...> &&tup) {
-    std::array<T, sizeof...(Args)> result{};
-    std::size_t i = 0;
-    std::apply([&result, &i](auto &&... v) {
-        ((result[i++] = v), ...);
-    }, tup);
-
-    return result;
-}
-
 template <typename T, typename Device>
 class Tensor;
 
@@ -167,6 +159,17 @@ public:
     Tensor(Tensor const &t):
         view_(t.view_), storage_(t.storage_), order_(t.order_) {}
 
+    /**
+     * \brief Move constructor. Takes over `t`'s storage handle without
+     *        touching the storage's reference count.
+     * \param Tensor to move from
+     */
+    Tensor(Tensor &&t) noexcept:
+        view_(std::move(t.view_)), storage_(std::move(t.storage_)), order_(t.order_) {}
+
+    Tensor &operator =(Tensor const &t) = default;
+    Tensor &operator =(Tensor &&t) noexcept = default;
+
     /**
      * \brief Constructs a Tensor with given a shape and order
      * \param shape The extent of the Tensor in each dimension
@@ -184,13 +187,24 @@ public:
     explicit Tensor(extent const &shape):
         Tensor(shape, TensorOrder::RowMajor) {}
 
+    /**
+     * \brief Constructs a Tensor whose elements are left uninitialized, for
+     *        results that are about to be completely overwritten
+     * \param shape The extent of the Tensor in each dimension
+     * \param order Either TensorOrder::RowMajor or TensorOrder::ColumnMajor
+     */
+    Tensor(extent shape, uninitialized_t, TensorOrder order=TensorOrder::RowMajor):
+        view_(shape, make_order(shape.size(), order)),
+        storage_(std::make_shared<Storage<T, Device>>(view_.num_elements(), uninitialized)),
+        order_(order) {}
+
     /**
      * \brief Constructs a Tensor with the given `storage` and `view`
      * \param storage The storage containing the Tensor's data
      * \param view The view of the storage
      */
     Tensor(std::shared_ptr<Storage<T, Device>> storage, const View &view):
-        view_(view), storage_(storage),
+        view_(view), storage_(std::move(storage)),
         order_(TensorOrder::RowMajor) {}
 
     /**
@@ -203,29 +217,59 @@ public:
         order_(TensorOrder::RowMajor) {}
 
     /**
-     * \brief Index operator
+     * \brief Constructs a Tensor by evaluating an elementwise expression
+     * \param expr The expression to evaluate (see `eval`)
+     */
+    template <typename E, typename = std::enable_if_t<is_expression_v<E>>>
+    Tensor(E const &expr):
+        Tensor(eval(expr)) {}
+
+    /**
+     * \brief Index operator, taking one index per dimension. Indices are not
+     *        checked; see `at` for a checked version.
      * \param cindices A sequence of index's used to calculate an offset
      * \return The value in the tensor for the given index
      */
     template <typename... Args>
-    T &operator ()(Args... cindices) {
-        auto array_indices = tuple_to_array<index_t>(std::tuple<Args...>(cindices...));
-        auto pos = calculate_offset(view_, array_indices);
-        return (*storage_)[pos];
+    T &operator ()(Args... cindices) const {
+        return at_unchecked(cindices...);
     }
 
     /**
-     * \brief Index operator
+     * \brief Returns the element at the given index, one per dimension,
+     *        without checking the number of indices or their range
      * \param cindices A sequence of index's used to calculate an offset
      * \return The value in the tensor for the given index
      */
     template <typename... Args>
-    T &operator ()(Args... cindices) const {
-        auto array_indices = tuple_to_array<index_t>(std::tuple<Args...>(cindices...));
-        auto pos = calculate_offset(view_, array_indices);
-        return (*storage_)[pos];
+    T &at_unchecked(Args... cindices) const {
+        return (*storage_)[unrolled_offset(view_, cindices...)];
     }
 
+    /**
+     * \brief Returns the element at the given index, one per dimension
+     * \param cindices A sequence of index's used to calculate an offset
+     * \return The value in the tensor for the given index
+     * \throws std::out_of_range if the number of indices doesn't match the
+     *         number of dimensions, or an index is past its dimension
+     */
+    template <typename... Args>
+    T &at(Args... cindices) const {
+        if (sizeof...(Args) != num_dims()) {
+            throw std::out_of_range(fmt::format("Expected {} indices, got {}",
+                                                num_dims(), sizeof...(Args)));
+        }
+
+        std::array<index_t, sizeof...(Args)> index{static_cast<index_t>(cindices)...};
+        for (std::size_t d = 0; d < index.size(); d++) {
+            if (index[d] >= view_.shape[d]) {
+                throw std::out_of_range(fmt::format("Index {} is out of range for dimension {} of size {}",
+                                                    index[d], d, view_.shape[d]));
+            }
+        }
+
+        return at_unchecked(cindices...);
+    }
 
     /**
      * \brief Index operator
@@ -256,19 +300,37 @@ public:
     /**
      * \brief Slice operator
      * \param index Index to set first dimension of Slice to
-     * \return A Slice with the same storage as this Tensor
+     * \return A Slice borrowing this Tensor's storage
+     */
+    Slice<T, Device> operator [](index_t index) const & {
+        return Slice<T, Device>(0, index, view_, storage_);
+    }
+
+    /**
+     * \brief Slice operator for temporaries
+     * \param index Index to set first dimension of Slice to
+     * \return A Slice that takes over this Tensor's storage
      */
-    Slice<T, Device> operator [](index_t index) const {
-        return Slice(0, index, view_, storage_);
+    Slice<T, Device> operator [](index_t index) && {
+        return Slice<T, Device>(0, index, view_, std::move(storage_));
     }
 
     /**
      * \brief Slice operator
      * \param index_index Range to set first dimension of Slice to
-     * \return A Slice with the same storage as this Tensor
+     * \return A Slice borrowing this Tensor's storage
+     */
+    Slice<T, Device> operator [](index_range_t index_range) const & {
+        return Slice<T, Device>(0, index_range, view_, storage_);
+    }
+
+    /**
+     * \brief Slice operator for temporaries
+     * \param index_index Range to set first dimension of Slice to
+     * \return A Slice that takes over this Tensor's storage
      */
-    Slice<T, Device> operator [](index_range_t index_range) const {
-        return Slice(0, index_range, view_, storage_);
+    Slice<T, Device> operator [](index_range_t index_range) && {
+        return Slice<T, Device>(0, index_range, view_, std::move(storage_));
     }
 
     /**
@@ -306,9 +368,22 @@ public:
 
     std::size_t num_dims() const { return view_.shape.size(); }
 
+    /**
+     * \brief Returns the strides of each dimension, in elements (from view)
+     * \return indices
+     */
+    ::indices const &strides() const { return view_.strides; }
+
+    /**
+     * \brief Returns a pointer to the Tensor's first element. Element
+     *        `(i0, i1, ...)` is at `data()[i0*strides()[0] + i1*strides()[1] + ...]`.
+     * \return T*
+     */
+    T *data() const { return storage_->data() + base_offset(view_); }
+
     Storage<T, Device> const &storage() const { return *storage_; }
     Storage<T, Device> &storage() { return *storage_; }
-    std::shared_ptr<Storage<T, Device>> storage_ptr() { return storage_; }
+    std::shared_ptr<Storage<T, Device>> const &storage_ptr() const { return storage_; }
 
     /**
      * \brief Returns true if Tensor is contiguous
@@ -362,12 +437,78 @@ Tensor<T, Device> make_contiguous(Tensor<T, Device> const &t) {
 
 template <typename T, typename Device>
 Tensor<T, Device> copy(Tensor<T, Device> const &tensor) {
-    auto new_storage = std::make_shared<Storage<T, Device>>(tensor.view().num_elements());
-    for (index_t i = 0; i < tensor.view().num_elements(); i++) {
-        (*new_storage)[i] = tensor.storage()[i];
+    TENSOR_PROFILE_OP("copy", 2*num_elements(tensor)*sizeof(T), tensor.shape());
+
+    Tensor<T, Device> result(tensor.shape(), uninitialized);
+    if (num_elements(tensor) == 0) return result;
+
+    auto loop = coalesce(result.shape(), stride_order(result.view().strides),
+                         {result.view().strides, tensor.view().strides});
+
+    auto const &from = tensor.storage();
+    auto &to = result.storage();
+
+    for_each_span<2>(loop, {base_offset(result.view()), base_offset(tensor.view())},
+        [&](auto const &offsets, index_t size) {
+            index_t to_stride = loop.strides[0][0];
+            index_t from_stride = loop.strides[1][0];
+
+            for (index_t i = 0; i < size; i++) {
+                to[offsets[0] + i*to_stride] = from[offsets[1] + i*from_stride];
+            }
+        });
+
+    return result;
+}
+
+/**
+ * \brief Number of elements spanned by a layout: one past the largest offset
+ *        any of its indices reaches
+ */
+inline std::size_t storage_size(extent const &shape, indices const &strides) {
+    std::size_t size = 1;
+    for (std::size_t i = 0; i < shape.size(); i++) {
+        if (shape[i] == 0) return 0;
+        size += (shape[i] - 1)*strides[i];
     }
 
-    return Tensor<T, Device>(new_storage, tensor.view());
+    return size;
+}
+
+/**
+ * \brief Creates a Tensor over memory owned by someone else, without copying
+ *        it. `data` must stay valid as long as the Tensor (or any Tensor
+ *        sharing its storage) is alive.
+ * \param data Pointer to the element at index `(0, ..., 0)`
+ * \param shape The extent of the Tensor in each dimension
+ * \param strides Distance, in elements, between consecutive indices of each
+ *        dimension
+ */
+template <typename T, typename Device=CPU>
+Tensor<T, Device> from_buffer(T *data, extent const &shape, indices const &strides) {
+    auto storage = std::make_shared<Storage<T, Device>>(data, storage_size(shape, strides));
+    return Tensor<T, Device>(storage, View(shape, stride_order(strides), strides));
+}
+
+/**
+ * \brief Creates a row-major Tensor over memory owned by someone else
+ */
+template <typename T, typename Device=CPU>
+Tensor<T, Device> from_buffer(T *data, extent const &shape) {
+    return from_buffer<T, Device>(data, shape, make_strides(shape, make_row_major_order(shape.size())));
+}
+
+/**
+ * \brief Creates a Tensor over `data` that takes ownership of it: once the
+ *        last Tensor sharing the storage is gone, `deleter(data)` is called
+ */
+template <typename T, typename Device=CPU, typename Deleter>
+Tensor<T, Device> from_buffer(T *data, extent const &shape, indices const &strides,
+                              Deleter deleter)
+{
+    auto storage = std::make_shared<Storage<T, Device>>(
+        data, storage_size(shape, strides), std::move(deleter));
+    return Tensor<T, Device>(storage, View(shape, stride_order(strides), strides));
 }
 
 // template <typename T, typename Device>
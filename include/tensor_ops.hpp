@@ -1,14 +1,21 @@
 #ifndef TENSOR_OPS_H
 #define TENSOR_OPS_H
 
+#include <functional>
 #include <stdexcept>
 
 #include <boost/optional.hpp>
 
 #include <fmt/format.h>
 
+#include <blas.hpp>
+#include <gemm.hpp>
+#include <profile.hpp>
+#include <simd.hpp>
 #include <tensor.hpp>
+#include <thread_pool.hpp>
 #include <types.hpp>
+#include <vmath.hpp>
 
 constexpr index_t expand = std::numeric_limits<index_t>::max();
 
@@ -46,8 +53,8 @@ struct NotEnoughDimensions: public TensorError {
  */
 template <typename T, typename Device=CPU>
 Tensor<T, Device> zeros(extent const &shape) {
-    Tensor<T, Device> result(shape);
-    fill(result, 0);
+    Tensor<T, Device> result(shape, uninitialized);
+    fill(result, T(0));
     return result;
 }
 
@@ -61,8 +68,8 @@ Tensor<T, Device> zeros(extent const &shape) {
  */
 template <typename T, typename Device=CPU>
 Tensor<T, Device> ones(extent const &shape) {
-    Tensor<T, Device> result(shape);
-    fill(result, 0);
+    Tensor<T, Device> result(shape, uninitialized);
+    fill(result, T(1));
     return result;
 }
 
@@ -79,9 +86,9 @@ void iota(Tensor<T, Device> &t, T start=0, T stride=1) {
 template <typename T, typename Device=CPU>
 Tensor<T, Device> range(T start, T end, T stride=1) {
     std::size_t size = std::floor((end - start) / stride);
-    Tensor<T, Device> result({size});
+    Tensor<T, Device> result({size}, uninitialized);
 
-    iota(result, start, end, stride);
+    iota(result, start, stride);
     return result;
 }
 
@@ -109,7 +116,9 @@ Tensor<T, Device> transpose(
         strides[i] = tensor.view().strides[order[i]];
     }
 
-    return tensor.view({shape, offset, order, strides});
+    View view(shape, offset, order, strides);
+    view.base = tensor.view().base;
+    return tensor.view(view);
 }
 
 // TODO: move to source
@@ -150,6 +159,8 @@ inline void calculate_reshape(extent const &from_shape, extent &to_shape) {
 // TODO: make this either respect order, or take order f strides
 template <typename T, typename Device>
 Tensor<T, Device> reshape(Tensor<T, Device> const &tensor, extent const &shape) {
+    TENSOR_PROFILE_OP("reshape", 0, tensor.shape(), shape);
+
     extent new_shape = shape;
     calculate_reshape(tensor.shape(), new_shape);
 
@@ -163,26 +174,63 @@ Tensor<T, Device> reshape(Tensor<T, Device> const &tensor, extent const &shape)
     auto strides = make_strides(new_shape, order);
     auto offset = make_offset(new_shape.size());
 
+    View view(new_shape, offset, order, strides);
+
+    // a sliced block keeps its parent's row-major order but not its dense
+    // strides, so it's compacted before being reinterpreted
+    if (tensor.contiguous() && !is_contiguous(tensor.view())) {
+        return copy(tensor).view(view);
+    }
+
+    view.base = tensor.view().base;
+
     if (tensor.contiguous()) {
-        return tensor.view({new_shape, offset, order, strides});
+        return tensor.view(view);
     }
 
-    return copy(tensor.view({new_shape, offset, order, strides}));
+    return copy(tensor.view(view));
 }
 
-template <typename T, typename Device>
-bool is_broadcastable_to(Tensor<T, Device> const &tensor, extent const &shape) {
-    if (shape.size() < tensor.shape().size()) return false;
+inline bool is_broadcastable_to(extent const &from, extent const &shape) {
+    if (shape.size() < from.size()) return false;
 
     auto shape_it = shape.rbegin();
-    auto tensor_shape_it = tensor.shape().rbegin();
-    for (; tensor_shape_it != tensor.shape().rend(); ++shape_it, ++tensor_shape_it) {
-        if (*shape_it != *tensor_shape_it && *tensor_shape_it != 1) return false;
+    auto from_it = from.rbegin();
+    for (; from_it != from.rend(); ++shape_it, ++from_it) {
+        if (*shape_it != *from_it && *from_it != 1) return false;
     }
 
     return true;
 }
 
+template <typename T, typename Device>
+bool is_broadcastable_to(Tensor<T, Device> const &tensor, extent const &shape) {
+    return is_broadcastable_to(tensor.shape(), shape);
+}
+
+/**
+ * @brief Returns the shape two operands are broadcast to in an elementwise op
+ */
+inline extent broadcast_shape(extent const &lhs, extent const &rhs) {
+    if (lhs == rhs) return lhs;
+
+    // dimensions are matched from the right; a missing or size 1 dimension
+    // stretches to match the other side
+    auto const &longer = lhs.size() >= rhs.size() ? lhs : rhs;
+    auto const &shorter = lhs.size() >= rhs.size() ? rhs : lhs;
+
+    extent result(longer);
+    auto lead = longer.size() - shorter.size();
+    for (std::size_t d = 0; d < shorter.size(); d++) {
+        auto &dim = result[lead + d];
+        if (shorter[d] == dim || shorter[d] == 1) continue;
+        if (dim != 1) throw CannotBroadcast(lhs, rhs);
+        dim = shorter[d];
+    }
+
+    return result;
+}
+
 namespace detail {
 
 template <typename T, typename Device>
@@ -193,6 +241,7 @@ Tensor<T, Device> broadcast_to(Tensor<T, Device> const &tensor, extent const &sh
 
     std::size_t diff = shape.size() - tensor.shape().size();
     for (index_t i = 0; i < tensor.shape().size(); i++) {
+        offset[diff+i] = tensor.view().offset[i];
         if (tensor.shape()[i] > 1) {
             strides[diff+i] = tensor.view().strides[i];
         } else {
@@ -200,13 +249,19 @@ Tensor<T, Device> broadcast_to(Tensor<T, Device> const &tensor, extent const &sh
         }
     }
 
-    return tensor.view({shape, offset, order, strides});
+    // a broadcast dimension has stride 0, so its offset can't be folded
+    // into `base` again
+    View view(shape, offset, order, strides);
+    view.base = tensor.view().base;
+    return tensor.view(view);
 }
 
 } // namespace detail
 
 template <typename T, typename Device>
 Tensor<T, Device> broadcast_to(Tensor<T, Device> const &tensor, extent const &shape) {
+    TENSOR_PROFILE_OP("broadcast_to", 0, tensor.shape(), shape);
+
     if (tensor.shape() == shape) return tensor;
 
     if (!is_broadcastable_to(tensor, shape)) {
@@ -233,6 +288,160 @@ broadcast(Tensor<T, Device> const &t1, Tensor<T, Device> const &t2) {
     return std::make_pair(result1, result2);
 }
 
+namespace detail {
+
+/**
+ * @brief Returns a pointer to the first element of `t` in storage
+ */
+template <typename T, typename Device>
+T *data_ptr(Tensor<T, Device> &t) {
+    return t.data();
+}
+
+template <typename T, typename Device>
+T const *data_ptr(Tensor<T, Device> const &t) {
+    return t.data();
+}
+
+// flat loops used when every operand walks storage in the same order; kept
+// free of any indexing so the compiler can vectorize them, and compiled for
+// each SIMD level
+template <typename RT, typename T, typename F>
+void apply_contiguous(RT *result, T const *lhs, T const *rhs, std::size_t size, F fn) {
+    simd_dispatch([&] {
+        for (std::size_t i = 0; i < size; i++) {
+            result[i] = fn(lhs[i], rhs[i]);
+        }
+    });
+}
+
+template <typename RT, typename T, typename F>
+void apply_contiguous(RT *result, T const *t, std::size_t size, F fn) {
+    simd_dispatch([&] {
+        for (std::size_t i = 0; i < size; i++) {
+            result[i] = fn(t[i]);
+        }
+    });
+}
+
+template <typename T, typename F>
+void iapply_contiguous(T *lhs, T const *rhs, std::size_t size, F fn) {
+    simd_dispatch([&] {
+        for (std::size_t i = 0; i < size; i++) {
+            lhs[i] = fn(lhs[i], rhs[i]);
+        }
+    });
+}
+
+template <typename T, typename F>
+void iapply_contiguous(T *t, std::size_t size, F fn) {
+    simd_dispatch([&] {
+        for (std::size_t i = 0; i < size; i++) {
+            t[i] = fn(t[i]);
+        }
+    });
+}
+
+// strided versions of the above, used for each innermost run of a coalesced
+// loop; they defer to the flat loops when every run is unit stride
+template <typename RT, typename T, typename F>
+void apply_span(RT *result, index_t result_stride,
+                T const *lhs, index_t lhs_stride,
+                T const *rhs, index_t rhs_stride,
+                std::size_t size, F fn)
+{
+    if (result_stride == 1 && lhs_stride == 1 && rhs_stride == 1) {
+        apply_contiguous(result, lhs, rhs, size, fn);
+        return;
+    }
+
+    for (std::size_t i = 0; i < size; i++) {
+        result[i*result_stride] = fn(lhs[i*lhs_stride], rhs[i*rhs_stride]);
+    }
+}
+
+template <typename RT, typename T, typename F>
+void apply_span(RT *result, index_t result_stride,
+                T const *t, index_t t_stride,
+                std::size_t size, F fn)
+{
+    if (result_stride == 1 && t_stride == 1) {
+        apply_contiguous(result, t, size, fn);
+        return;
+    }
+
+    for (std::size_t i = 0; i < size; i++) {
+        result[i*result_stride] = fn(t[i*t_stride]);
+    }
+}
+
+template <typename T, typename F>
+void iapply_span(T *lhs, index_t lhs_stride,
+                 T const *rhs, index_t rhs_stride,
+                 std::size_t size, F fn)
+{
+    if (lhs_stride == 1 && rhs_stride == 1) {
+        iapply_contiguous(lhs, rhs, size, fn);
+        return;
+    }
+
+    for (std::size_t i = 0; i < size; i++) {
+        lhs[i*lhs_stride] = fn(lhs[i*lhs_stride], rhs[i*rhs_stride]);
+    }
+}
+
+template <typename T, typename F>
+void iapply_span(T *t, index_t t_stride, std::size_t size, F fn) {
+    if (t_stride == 1) {
+        iapply_contiguous(t, size, fn);
+        return;
+    }
+
+    for (std::size_t i = 0; i < size; i++) {
+        t[i*t_stride] = fn(t[i*t_stride]);
+    }
+}
+
+/**
+ * @brief Splits the runs of `loop` into chunks of roughly `grain` elements
+ *        and calls `fn(offsets, length)` for each run on the thread pool
+ */
+template <std::size_t N, typename F>
+void parallel_for_each_span(LoopLayout const &loop, index_t grain, F fn) {
+    parallel_for(0, num_spans(loop), std::max<index_t>(1, grain/loop.shape[0]),
+        [&loop, &fn](index_t begin, index_t end) {
+            for_each_span<N>(loop, {}, begin, end, fn);
+        });
+}
+
+template <typename T, typename Device, typename F>
+void iapply(Tensor<T, Device> &t, F fn, index_t grain) {
+    if (is_contiguous(t.view())) {
+        auto t_data = data_ptr(t);
+
+        parallel_for(0, num_elements(t), grain, [t_data, &fn](index_t begin, index_t end) {
+            iapply_contiguous(t_data + begin, end - begin, fn);
+        });
+        return;
+    }
+
+    if (num_elements(t) == 0) return;
+
+    // elements are visited in the view's own order, which `fill` relies on
+    auto loop = coalesce(t.shape(), t.view().order, {t.view().strides});
+    auto t_data = data_ptr(t);
+
+    parallel_for_each_span<1>(loop, grain, [&](auto const &offsets, index_t size) {
+        iapply_span(t_data + offsets[0], loop.strides[0][0], size, fn);
+    });
+}
+
+} // namespace detail
+
+// Elementwise operations are split across the thread pool once they touch
+// more than `parallel_grain_size()` elements, so `fn` must be safe to call
+// concurrently.
+
 template <typename RT, typename T, typename Device, typename F>
 Tensor<RT, Device> apply(Tensor<T, Device> const &lhs,
                          Tensor<T, Device> const &rhs,
@@ -244,13 +453,40 @@ Tensor<RT, Device> apply(Tensor<T, Device> const &lhs,
         return apply<RT>(lhs_broadcast, rhs_broadcast, fn);
     }
 
-    Tensor<RT, Device> result(lhs.shape());
+    TENSOR_PROFILE_OP("apply", num_elements(lhs)*(2*sizeof(T) + sizeof(RT)),
+                      lhs.shape(), rhs.shape());
+
+    Tensor<RT, Device> result(lhs.shape(), uninitialized);
 
-    // can optimize if both lhs and rhs are contiguous
-    for (auto const &index : lhs.indices()) {
-        result(index) = fn(lhs(index), rhs(index));
+    auto result_data = detail::data_ptr(result);
+    auto lhs_data = detail::data_ptr(lhs);
+    auto rhs_data = detail::data_ptr(rhs);
+
+    if (is_contiguous(lhs.view()) &&
+        same_strides(lhs.view(), rhs.view()) &&
+        same_strides(lhs.view(), result.view()))
+    {
+        parallel_for(0, num_elements(lhs), parallel_grain_size(), [&](index_t begin, index_t end) {
+            detail::apply_contiguous(result_data + begin, lhs_data + begin,
+                                     rhs_data + begin, end - begin, fn);
+        });
+        return result;
     }
 
+    if (num_elements(result) == 0) return result;
+
+    // otherwise iterate in the result's storage order over as few dimensions
+    // as the three layouts allow
+    auto loop = coalesce(result.shape(), stride_order(result.view().strides),
+                         {result.view().strides, lhs.view().strides, rhs.view().strides});
+
+    detail::parallel_for_each_span<3>(loop, parallel_grain_size(), [&](auto const &offsets, index_t size) {
+        detail::apply_span(result_data + offsets[0], loop.strides[0][0],
+                           lhs_data + offsets[1], loop.strides[1][0],
+                           rhs_data + offsets[2], loop.strides[2][0],
+                           size, fn);
+    });
+
     return result;
 }
 
@@ -260,27 +496,65 @@ void iapply(Tensor<T, Device> &lhs, Tensor<T, Device> const &rhs, F fn) {
         throw MismatchedDimensions(lhs.shape(), rhs.shape());
     }
 
-    // can optimize if both lhs and rhs are contiguous
-    for (auto const &index : lhs.indices()) {
-        lhs(index) = fn(lhs(index), rhs(index));
+    TENSOR_PROFILE_OP("iapply", 3*num_elements(lhs)*sizeof(T), lhs.shape(), rhs.shape());
+
+    auto lhs_data = detail::data_ptr(lhs);
+    auto rhs_data = detail::data_ptr(rhs);
+
+    if (is_contiguous(lhs.view()) && same_strides(lhs.view(), rhs.view())) {
+        parallel_for(0, num_elements(lhs), parallel_grain_size(), [&](index_t begin, index_t end) {
+            detail::iapply_contiguous(lhs_data + begin, rhs_data + begin, end - begin, fn);
+        });
+        return;
     }
+
+    if (num_elements(lhs) == 0) return;
+
+    auto loop = coalesce(lhs.shape(), stride_order(lhs.view().strides),
+                         {lhs.view().strides, rhs.view().strides});
+
+    detail::parallel_for_each_span<2>(loop, parallel_grain_size(), [&](auto const &offsets, index_t size) {
+        detail::iapply_span(lhs_data + offsets[0], loop.strides[0][0],
+                            rhs_data + offsets[1], loop.strides[1][0],
+                            size, fn);
+    });
 }
 
 template <typename RT, typename T, typename Device, typename F>
 Tensor<RT, Device> apply(Tensor<T, Device> const &t, F fn) {
-    Tensor<RT, Device> result(t.shape());
-    for (auto const &index : t.indices()) {
-        result(index) = fn(t(index));
+    TENSOR_PROFILE_OP("apply", num_elements(t)*(sizeof(T) + sizeof(RT)), t.shape());
+
+    Tensor<RT, Device> result(t.shape(), uninitialized);
+
+    auto result_data = detail::data_ptr(result);
+    auto t_data = detail::data_ptr(t);
+
+    if (is_contiguous(t.view()) && same_strides(t.view(), result.view())) {
+        parallel_for(0, num_elements(t), parallel_grain_size(), [&](index_t begin, index_t end) {
+            detail::apply_contiguous(result_data + begin, t_data + begin, end - begin, fn);
+        });
+        return result;
     }
 
+    if (num_elements(result) == 0) return result;
+
+    auto loop = coalesce(result.shape(), stride_order(result.view().strides),
+                         {result.view().strides, t.view().strides});
+
+    detail::parallel_for_each_span<2>(loop, parallel_grain_size(), [&](auto const &offsets, index_t size) {
+        detail::apply_span(result_data + offsets[0], loop.strides[0][0],
+                           t_data + offsets[1], loop.strides[1][0],
+                           size, fn);
+    });
+
     return result;
 }
 
 template <typename T, typename Device, typename F>
 void iapply(Tensor<T, Device> &t, F fn) {
-    for (auto const &index : t.indices()) {
-        t(index) = fn(t(index));
-    }
+    TENSOR_PROFILE_OP("iapply", 2*num_elements(t)*sizeof(T), t.shape());
+
+    detail::iapply(t, fn, parallel_grain_size());
 }
 
 /**
@@ -307,12 +581,182 @@ void fill(Tensor<T, Device> &t, T const &value) {
  */
 template <typename T, typename Device, typename F>
 void fill(Tensor<T, Device> &t, F fn) {
-    iapply(t, [fn](T const &) { return fn(); });
+    // `fn` is usually stateful, so always call it from a single thread
+    detail::iapply(t, [&fn](T const &) { return fn(); }, num_elements(t));
+}
+
+namespace detail {
+
+template <typename T, typename Device>
+TensorOperand<T, Device> make_operand(Tensor<T, Device> const &tensor) {
+    return TensorOperand<T, Device>(tensor);
+}
+
+template <typename E, typename = std::enable_if_t<is_expression_v<E>>>
+E const &make_operand(E const &expr) {
+    return expr;
+}
+
+template <typename Op, typename L, typename R>
+auto make_expression(L const &lhs, R const &rhs) {
+    static_assert(std::is_same_v<typename L::NumericType, typename R::NumericType>,
+                  "Operands must have the same element type");
+    static_assert(std::is_same_v<typename L::Device, typename R::Device>,
+                  "Operands must be on the same device");
+
+    auto lhs_operand = make_operand(lhs);
+    auto rhs_operand = make_operand(rhs);
+
+    return BinaryExpression<Op, decltype(lhs_operand), decltype(rhs_operand)>(
+        lhs_operand, rhs_operand, broadcast_shape(lhs.shape(), rhs.shape()));
+}
+
+/**
+ * @brief Evaluates `expr`, whose leaves were collected into `operands`, into
+ *        `result` in a single pass, storing `fn(old value, expression value)`
+ *        at every index
+ */
+template <typename T, typename Device, typename E, typename F>
+void assign(Tensor<T, Device> &result, E const &expr,
+            std::vector<Tensor<T, Device>> operands, F fn)
+{
+    constexpr std::size_t N = E::leaves;
+
+    if (num_elements(result) == 0) return;
+
+    // the expression's shape is already the operands' broadcast shape
+    std::vector<indices> strides{result.view().strides};
+    for (auto &operand : operands) {
+        if (operand.shape() != result.shape()) {
+            operand = detail::broadcast_to(operand, result.shape());
+        }
+        strides.push_back(operand.view().strides);
+    }
+
+    std::array<T const *, N> data;
+    for (std::size_t i = 0; i < N; i++) {
+        data[i] = data_ptr(operands[i]);
+    }
+
+    auto loop = coalesce(result.shape(), stride_order(result.view().strides), strides);
+    auto result_data = data_ptr(result);
+
+    parallel_for_each_span<N+1>(loop, parallel_grain_size(), [&](auto const &offsets, index_t size) {
+        T *out = result_data + offsets[0];
+        index_t out_stride = loop.strides[0][0];
+
+        bool unit_stride = out_stride == 1;
+        std::array<T const *, N> span_data;
+        std::array<index_t, N> span_strides;
+        for (std::size_t i = 0; i < N; i++) {
+            span_data[i] = data[i] + offsets[i+1];
+            span_strides[i] = loop.strides[i+1][0];
+            unit_stride = unit_stride && span_strides[i] == 1;
+        }
+
+        if (unit_stride) {
+            simd_dispatch([&] {
+                for (index_t i = 0; i < size; i++) {
+                    out[i] = fn(out[i], expr.template at<0>(span_data, i));
+                }
+            });
+        } else {
+            for (index_t i = 0; i < size; i++) {
+                out[i*out_stride] = fn(out[i*out_stride],
+                                       expr.template at<0>(span_data, span_strides, i));
+            }
+        }
+    });
+}
+
+/**
+ * @brief Evaluates `expr` into `lhs` (whose shape must match the expression's),
+ *        combining with the existing values using `fn`
+ */
+template <typename T, typename Device, typename E, typename F>
+void iassign(Tensor<T, Device> &lhs, E const &expr, F fn) {
+    if (lhs.shape() != expr.shape()) {
+        throw MismatchedDimensions(lhs.shape(), expr.shape());
+    }
+
+    // the fused loop overwrites `lhs` as it goes, so an operand reading the
+    // same storage through any other view (e.g. `a += transpose(a) + b`, or a
+    // row of `a` broadcast across it) would see updated values; evaluate
+    // those expressions first
+    std::vector<Tensor<T, Device>> operands;
+    expr.collect(operands);
+
+    for (auto const &operand : operands) {
+        if (operand.storage_ptr() != lhs.storage_ptr()) continue;
+
+        auto const &view = operand.view();
+        if (operand.shape() != lhs.shape() || view.base != lhs.view().base ||
+            view.strides != lhs.view().strides) {
+            iapply(lhs, eval(expr), fn);
+            return;
+        }
+    }
+
+    // each operand is read once per element, lhs is read and written
+    TENSOR_PROFILE_OPERANDS("iapply", (operands.size() + 2)*num_elements(lhs)*sizeof(T),
+                            operands);
+
+    assign(lhs, expr, std::move(operands), fn);
+}
+
+} // namespace detail
+
+/**
+ * @brief Evaluates an elementwise expression into a new Tensor
+ *
+ * @tparam E The expression type
+ * @param expr The expression to evaluate
+ * @return Tensor<typename E::NumericType, typename E::Device>
+ */
+template <typename E, typename = std::enable_if_t<is_expression_v<E>>>
+Tensor<typename E::NumericType, typename E::Device> eval(E const &expr) {
+    using T = typename E::NumericType;
+
+    std::vector<Tensor<T, typename E::Device>> operands;
+    expr.collect(operands);
+
+    TENSOR_PROFILE_OPERANDS("apply", (operands.size() + 1)*num_elements(expr.shape())*sizeof(T),
+                            operands);
+
+    Tensor<T, typename E::Device> result(expr.shape(), uninitialized);
+    detail::assign(result, expr, std::move(operands),
+                   [](T const &, T const &value) { return value; });
+    return result;
 }
 
 template <typename T, typename Device>
-Tensor<T, Device> operator +(Tensor<T, Device> const &lhs, Tensor<T, Device> const &rhs) {
-    return apply<T>(lhs, rhs, [](T const &lop, T const &rop) { return lop + rop; });
+Tensor<T, Device> eval(Tensor<T, Device> const &tensor) {
+    return tensor;
+}
+
+// the elementwise arithmetic operators build expressions, which are
+// evaluated when assigned to a Tensor (or by `eval`)
+template <typename L, typename R,
+          typename = std::enable_if_t<is_operand_v<L> && is_operand_v<R>>>
+auto operator +(L const &lhs, R const &rhs) {
+    return detail::make_expression<std::plus<>>(lhs, rhs);
+}
+
+template <typename L, typename R,
+          typename = std::enable_if_t<is_operand_v<L> && is_operand_v<R>>>
+auto operator -(L const &lhs, R const &rhs) {
+    return detail::make_expression<std::minus<>>(lhs, rhs);
+}
+
+template <typename L, typename R,
+          typename = std::enable_if_t<is_operand_v<L> && is_operand_v<R>>>
+auto operator /(L const &lhs, R const &rhs) {
+    return detail::make_expression<std::divides<>>(lhs, rhs);
+}
+
+template <typename T, typename Device>
+auto operator *(ElementTensor<T, Device> lhs, ElementTensor<T, Device> rhs) {
+    return detail::make_expression<std::multiplies<>>(lhs.tensor, rhs.tensor);
 }
 
 template <typename T, typename Device>
@@ -321,9 +765,11 @@ Tensor<T, Device> &operator +=(Tensor<T, Device> &lhs, Tensor<T, Device> const &
     return lhs;
 }
 
-template <typename T, typename Device>
-Tensor<T, Device> operator -(Tensor<T, Device> const &lhs, Tensor<T, Device> const &rhs) {
-    return apply<T>(lhs, rhs, [](T const &lop, T const &rop) { return lop - rop; });
+template <typename T, typename Device, typename E,
+          typename = std::enable_if_t<is_expression_v<E>>>
+Tensor<T, Device> &operator +=(Tensor<T, Device> &lhs, E const &rhs) {
+    detail::iassign(lhs, rhs, [](T const &lop, T const &rop) { return lop + rop; });
+    return lhs;
 }
 
 template <typename T, typename Device>
@@ -332,11 +778,11 @@ Tensor<T, Device> &operator -=(Tensor<T, Device> &lhs, Tensor<T, Device> const &
     return lhs;
 }
 
-template <typename T, typename Device>
-Tensor<T, Device> operator *(ElementTensor<T, Device> lhs, ElementTensor<T, Device> rhs) {
-    return apply<T>(lhs.tensor, rhs.tensor, [](T const &lop, T const &rop) {
-        return lop * rop;
-    });
+template <typename T, typename Device, typename E,
+          typename = std::enable_if_t<is_expression_v<E>>>
+Tensor<T, Device> &operator -=(Tensor<T, Device> &lhs, E const &rhs) {
+    detail::iassign(lhs, rhs, [](T const &lop, T const &rop) { return lop - rop; });
+    return lhs;
 }
 
 template <typename T, typename Device>
@@ -345,27 +791,253 @@ Tensor<T, Device> &operator *=(ElementTensor<T, Device> lhs, ElementTensor<T, De
     return lhs.tensor;
 }
 
-template <typename T, typename Device>
-Tensor<T, Device> operator /(Tensor<T, Device> const &lhs, Tensor<T, Device> const &rhs) {
-    return apply<T>(lhs, rhs, [](T const &lop, T const &rop) { return lop / rop; });
-}
-
 template <typename T, typename Device>
 Tensor<T, Device> &operator /=(Tensor<T, Device> &lhs, Tensor<T, Device> const &rhs) {
     iapply(lhs, rhs, [](T const &lop, T const &rop) { return lop / rop; });
     return lhs;
 }
 
+template <typename T, typename Device, typename E,
+          typename = std::enable_if_t<is_expression_v<E>>>
+Tensor<T, Device> &operator /=(Tensor<T, Device> &lhs, E const &rhs) {
+    detail::iassign(lhs, rhs, [](T const &lop, T const &rop) { return lop / rop; });
+    return lhs;
+}
+
+namespace detail {
+
+// strided runs are gathered into blocks of this many elements for the
+// unary math kernels
+constexpr index_t unary_block_size = 256;
+
+/**
+ * @brief Stores `kernel(t)` in `result`, which has `t`'s shape and may be
+ *        `t` itself. `kernel(x, y, n)` maps `n` contiguous elements of `x`
+ *        into `y` (see vmath.hpp); strided runs go through a local buffer.
+ */
+template <typename T, typename Device, typename Kernel>
+void map_unary(Tensor<T, Device> &result, Tensor<T, Device> const &t, Kernel kernel) {
+    auto result_data = data_ptr(result);
+    auto t_data = data_ptr(t);
+
+    if (is_contiguous(t.view()) && same_strides(t.view(), result.view())) {
+        parallel_for(0, num_elements(t), parallel_grain_size(), [&](index_t begin, index_t end) {
+            kernel(t_data + begin, result_data + begin, end - begin);
+        });
+        return;
+    }
+
+    if (num_elements(t) == 0) return;
+
+    auto loop = coalesce(result.shape(), stride_order(result.view().strides),
+                         {result.view().strides, t.view().strides});
+
+    parallel_for_each_span<2>(loop, parallel_grain_size(), [&](auto const &offsets, index_t size) {
+        T *out = result_data + offsets[0];
+        T const *in = t_data + offsets[1];
+        index_t out_stride = loop.strides[0][0];
+        index_t in_stride = loop.strides[1][0];
+
+        if (out_stride == 1 && in_stride == 1) {
+            kernel(in, out, size);
+            return;
+        }
+
+        T buffer[unary_block_size];
+        for (index_t start = 0; start < size; start += unary_block_size) {
+            index_t count = std::min(unary_block_size, size - start);
+            for (index_t i = 0; i < count; i++) buffer[i] = in[(start + i)*in_stride];
+            kernel(buffer, buffer, count);
+            for (index_t i = 0; i < count; i++) out[(start + i)*out_stride] = buffer[i];
+        }
+    });
+}
+
+template <typename T, typename Device, typename Kernel>
+Tensor<T, Device> map_unary(Tensor<T, Device> const &t, Kernel kernel) {
+    Tensor<T, Device> result(t.shape(), uninitialized);
+    map_unary(result, t, kernel);
+    return result;
+}
+
+} // namespace detail
+
+// Elementwise math functions, each with an in-place `i` variant. Single
+// precision tensors use the vectorized approximations in vmath.hpp, whose
+// accuracy is documented there.
+
+template <typename T, typename Device>
+Tensor<T, Device> exp(Tensor<T, Device> const &t) {
+    return detail::map_unary(t, [](T const *x, T *y, std::size_t n) { vmath::exp(x, y, n); });
+}
+
+template <typename T, typename Device>
+void iexp(Tensor<T, Device> &t) {
+    detail::map_unary(t, t, [](T const *x, T *y, std::size_t n) { vmath::exp(x, y, n); });
+}
+
+template <typename T, typename Device>
+Tensor<T, Device> log(Tensor<T, Device> const &t) {
+    return detail::map_unary(t, [](T const *x, T *y, std::size_t n) { vmath::log(x, y, n); });
+}
+
+template <typename T, typename Device>
+void ilog(Tensor<T, Device> &t) {
+    detail::map_unary(t, t, [](T const *x, T *y, std::size_t n) { vmath::log(x, y, n); });
+}
+
+template <typename T, typename Device>
+Tensor<T, Device> tanh(Tensor<T, Device> const &t) {
+    return detail::map_unary(t, [](T const *x, T *y, std::size_t n) { vmath::tanh(x, y, n); });
+}
+
+template <typename T, typename Device>
+void itanh(Tensor<T, Device> &t) {
+    detail::map_unary(t, t, [](T const *x, T *y, std::size_t n) { vmath::tanh(x, y, n); });
+}
+
+/**
+ * @brief The logistic function 1/(1 + exp(-x))
+ */
+template <typename T, typename Device>
+Tensor<T, Device> sigmoid(Tensor<T, Device> const &t) {
+    return detail::map_unary(t, [](T const *x, T *y, std::size_t n) { vmath::sigmoid(x, y, n); });
+}
+
+template <typename T, typename Device>
+void isigmoid(Tensor<T, Device> &t) {
+    detail::map_unary(t, t, [](T const *x, T *y, std::size_t n) { vmath::sigmoid(x, y, n); });
+}
+
+template <typename T, typename Device>
+Tensor<T, Device> sqrt(Tensor<T, Device> const &t) {
+    return detail::map_unary(t, [](T const *x, T *y, std::size_t n) { vmath::sqrt(x, y, n); });
+}
+
 template <typename T, typename Device>
-Tensor<T, Device> sin(Tensor<T, Device> &t) {
-    return apply<T>(t, [](T const &v) { return std::sin(v); });
+void isqrt(Tensor<T, Device> &t) {
+    detail::map_unary(t, t, [](T const *x, T *y, std::size_t n) { vmath::sqrt(x, y, n); });
+}
+
+/**
+ * @brief The reciprocal square root 1/sqrt(x)
+ */
+template <typename T, typename Device>
+Tensor<T, Device> rsqrt(Tensor<T, Device> const &t) {
+    return detail::map_unary(t, [](T const *x, T *y, std::size_t n) { vmath::rsqrt(x, y, n); });
+}
+
+template <typename T, typename Device>
+void irsqrt(Tensor<T, Device> &t) {
+    detail::map_unary(t, t, [](T const *x, T *y, std::size_t n) { vmath::rsqrt(x, y, n); });
+}
+
+template <typename T, typename Device>
+Tensor<T, Device> sin(Tensor<T, Device> const &t) {
+    return detail::map_unary(t, [](T const *x, T *y, std::size_t n) { vmath::sin(x, y, n); });
 }
 
 template <typename T, typename Device>
 void isin(Tensor<T, Device> &t) {
-    iapply(t, [](T const &v) { return std::sin(v); });
+    detail::map_unary(t, t, [](T const *x, T *y, std::size_t n) { vmath::sin(x, y, n); });
+}
+
+template <typename T, typename Device>
+Tensor<T, Device> cos(Tensor<T, Device> const &t) {
+    return detail::map_unary(t, [](T const *x, T *y, std::size_t n) { vmath::cos(x, y, n); });
+}
+
+template <typename T, typename Device>
+void icos(Tensor<T, Device> &t) {
+    detail::map_unary(t, t, [](T const *x, T *y, std::size_t n) { vmath::cos(x, y, n); });
+}
+
+template <typename T, typename Device>
+Tensor<T, Device> erf(Tensor<T, Device> const &t) {
+    return detail::map_unary(t, [](T const *x, T *y, std::size_t n) { vmath::erf(x, y, n); });
+}
+
+template <typename T, typename Device>
+void ierf(Tensor<T, Device> &t) {
+    detail::map_unary(t, t, [](T const *x, T *y, std::size_t n) { vmath::erf(x, y, n); });
+}
+
+namespace detail {
+
+/**
+ * @brief Describes the last two dimensions of `t` (from `offset` in storage)
+ *        as a strided matrix
+ */
+template <typename T, typename Device>
+MatrixRef<T const> matrix_ref(Tensor<T, Device> const &t, offset_t offset=0) {
+    auto const &strides = t.view().strides;
+    auto dims = strides.size();
+    return {data_ptr(t) + offset, strides[dims-2], strides[dims-1]};
 }
 
+template <typename T, typename Device>
+MatrixRef<T> matrix_ref(Tensor<T, Device> &t, offset_t offset=0) {
+    auto const &strides = t.view().strides;
+    auto dims = strides.size();
+    return {data_ptr(t) + offset, strides[dims-2], strides[dims-1]};
+}
+
+// matrix kernels for each device; CPU_BLAS uses the system BLAS whenever it
+// can express the operands, and the native kernels otherwise
+template <typename T>
+void device_gemm(CPU, index_t m, index_t n, index_t k,
+                 MatrixRef<T const> a, MatrixRef<T const> b, MatrixRef<T> c)
+{
+    gemm(m, n, k, a, b, c);
+}
+
+template <typename T>
+void device_gemm(CPU_BLAS, index_t m, index_t n, index_t k,
+                 MatrixRef<T const> a, MatrixRef<T const> b, MatrixRef<T> c)
+{
+    if (!blas::gemm(m, n, k, a, b, c)) gemm(m, n, k, a, b, c);
+}
+
+// true when a device's gemm is handed to a BLAS that runs its own threads,
+// so callers shouldn't spread several of them over the pool as well
+template <typename T>
+constexpr bool device_gemm_threaded(CPU) { return false; }
+
+template <typename T>
+constexpr bool device_gemm_threaded(CPU_BLAS) {
+    return blas::available() && blas::detail::supported_type<T>;
+}
+
+template <typename T>
+void device_gemv(CPU, index_t m, index_t n, MatrixRef<T const> a,
+                 T const *x, index_t x_stride, T *y, index_t y_stride)
+{
+    gemv(m, n, a, x, x_stride, y, y_stride);
+}
+
+template <typename T>
+void device_gemv(CPU_BLAS, index_t m, index_t n, MatrixRef<T const> a,
+                 T const *x, index_t x_stride, T *y, index_t y_stride)
+{
+    if (!blas::gemv(m, n, a, x, x_stride, y, y_stride)) {
+        gemv(m, n, a, x, x_stride, y, y_stride);
+    }
+}
+
+template <typename T>
+T device_dot(CPU, index_t n, T const *x, index_t x_stride, T const *y, index_t y_stride) {
+    return dot(n, x, x_stride, y, y_stride);
+}
+
+template <typename T>
+T device_dot(CPU_BLAS, index_t n, T const *x, index_t x_stride, T const *y, index_t y_stride) {
+    T result;
+    if (blas::dot(n, x, x_stride, y, y_stride, result)) return result;
+    return dot(n, x, x_stride, y, y_stride);
+}
+
+} // namespace detail
+
 // move to detail
 template <typename T, typename Device>
 Tensor<T, Device> vector_vector_product(Tensor<T, Device> const &lhs,
@@ -375,12 +1047,11 @@ Tensor<T, Device> vector_vector_product(Tensor<T, Device> const &lhs,
         throw MismatchedNumberOfElements(num_elements(lhs), num_elements(rhs));
     }
 
-    T result(0);
-    for (index_t i = 0; i < num_elements(lhs); i++) {
-        result += lhs(i)*rhs(i);
-    }
+    T result = detail::device_dot(Device{}, num_elements(lhs),
+                                  detail::data_ptr(lhs), lhs.view().strides[0],
+                                  detail::data_ptr(rhs), rhs.view().strides[0]);
 
-    return tensor({result});
+    return tensor<T, Device>({result});
 }
 
 template <typename T, typename Device>
@@ -388,15 +1059,17 @@ Tensor<T, Device> matrix_vector_product(Tensor<T, Device> const &lhs,
                                         Tensor<T, Device> const &rhs)
 {
     // verify inner dimensions match: (Nx1, 1)
-    Tensor<T, Device> result({lhs.shape()[0]});
-    fill(result, 0);
-
-    for (index_t i = 0; i < lhs.shape()[0]; i++) {
-        for (index_t j = 0; j < lhs.shape()[1]; j++) {
-            result(i) += lhs(i, j)*rhs(j);
-        }
+    if (lhs.shape()[1] != rhs.shape()[0]) {
+        throw MismatchedDimensions(lhs.shape(), rhs.shape());
     }
 
+    Tensor<T, Device> result({lhs.shape()[0]}, uninitialized);
+    fill(result, T(0));
+
+    detail::device_gemv(Device{}, lhs.shape()[0], lhs.shape()[1], detail::matrix_ref(lhs),
+                        detail::data_ptr(rhs), rhs.view().strides[0],
+                        detail::data_ptr(result), result.view().strides[0]);
+
     return result;
 }
 
@@ -406,58 +1079,116 @@ template <typename T, typename Device>
 Tensor<T, Device> matrix_matrix_product(Tensor<T, Device> const &lhs,
                                         Tensor<T, Device> const &rhs)
 {
-    Tensor<T, Device> result({lhs.shape()[0], rhs.shape()[1]});
-    fill(result, 0);
-
-    for (index_t i = 0; i < lhs.shape()[0]; i++) {
-        for (index_t j = 0; j < lhs.shape()[1]; j++) {
-            for (index_t k = 0; k < rhs.shape()[1]; k++) {
-                result(i, k) += lhs(i, j)*rhs(j, k);
-            }
-        }
+    if (lhs.shape()[1] != rhs.shape()[0]) {
+        throw MismatchedDimensions(lhs.shape(), rhs.shape());
     }
 
+    Tensor<T, Device> result({lhs.shape()[0], rhs.shape()[1]}, uninitialized);
+    fill(result, T(0));
+
+    detail::device_gemm(Device{}, lhs.shape()[0], rhs.shape()[1], lhs.shape()[1],
+                        detail::matrix_ref(lhs), detail::matrix_ref(rhs),
+                        detail::matrix_ref(result));
+
     return result;
 }
 
+namespace detail {
+
+// strides of the batch dimensions of `t` (all but the last two), aligned to
+// the right of a batch of `batch_dims` dimensions; dimensions `t` lacks or
+// broadcasts (size 1) get a stride of 0
+template <typename T, typename Device>
+indices batch_strides(Tensor<T, Device> const &t, std::size_t batch_dims) {
+    indices strides(batch_dims, 0);
+
+    auto dims = num_dims(t) - 2;
+    auto lead = batch_dims - dims;
+    for (std::size_t d = 0; d < dims; d++) {
+        if (t.shape()[d] != 1) strides[lead + d] = t.view().strides[d];
+    }
+
+    return strides;
+}
+
+} // namespace detail
+
+/**
+ * @brief Batched matrix product of `...xMxK` and `...xKxN` tensors.
+ *
+ * The batch dimensions (all but the last two) are broadcast against each
+ * other, so e.g. `Bx1xMxK * HxKxN` gives `BxHxMxN`. Operands are read in
+ * place through their strides, so transposed, sliced or broadcast batches
+ * are never copied. Batches are split across threads; when there are fewer
+ * batches than threads, or products go to a multi-threaded BLAS
+ * (`CPU_BLAS`), each product is parallelized on its own instead.
+ */
 template <typename T, typename Device>
 Tensor<T, Device> batch_matrix_matrix_product(Tensor<T, Device> const &lhs,
                                               Tensor<T, Device> const &rhs)
 {
-    // BxMxN * BxNxP
-    Tensor<T, Device> result({lhs.shape()[0], lhs.shape()[1], rhs.shape()[2]});
-    fill(result, 0);
-
-    for (index_t b = 0; b < lhs.shape()[0]; b++) {
-        for (index_t i = 0; i < lhs.shape()[1]; i++) {
-            for (index_t j = 0; j < lhs.shape()[2]; j++) {
-                for (index_t k = 0; k < rhs.shape()[2]; k++) {
-                    result(b, i, k) += lhs(b, i, j)*rhs(b, j, k);
-                }
-            }
-        }
-    }
+    auto lhs_dims = num_dims(lhs);
+    auto rhs_dims = num_dims(rhs);
 
-    return result;
-}
+    if (lhs_dims < 2) throw NotEnoughDimensions(lhs.shape());
+    if (rhs_dims < 2) throw NotEnoughDimensions(rhs.shape());
+
+    index_t m = lhs.shape()[lhs_dims-2];
+    index_t k = lhs.shape()[lhs_dims-1];
+    index_t n = rhs.shape()[rhs_dims-1];
 
+    if (rhs.shape()[rhs_dims-2] != k) {
+        throw MismatchedDimensions(lhs.shape(), rhs.shape());
+    }
 
-inline extent get_batch_shape(extent const &shape) {
-    if (shape.size() < 3) throw NotEnoughDimensions(shape);
-    std::size_t count = shape.size() - 2;
+    extent lhs_batch(lhs.shape().begin(), lhs.shape().end() - 2);
+    extent rhs_batch(rhs.shape().begin(), rhs.shape().end() - 2);
+    auto batch_shape = broadcast_shape(lhs_batch, rhs_batch);
+
+    auto result_shape = batch_shape;
+    result_shape.push_back(m);
+    result_shape.push_back(n);
+
+    Tensor<T, Device> result(result_shape, uninitialized);
+    fill(result, T(0));
+
+    // offset of each batch entry of lhs and rhs, in the result's (row-major)
+    // batch order
+    index_t num_batches = ::num_elements(batch_shape);
+    std::vector<offset_t> lhs_offsets, rhs_offsets;
+    lhs_offsets.reserve(num_batches);
+    rhs_offsets.reserve(num_batches);
+
+    auto order = make_row_major_order(batch_shape.size());
+    index_generator batches(View(batch_shape, order, detail::batch_strides(lhs, batch_shape.size())),
+                            View(batch_shape, order, detail::batch_strides(rhs, batch_shape.size())));
+    for (; !batches.done(); batches.next()) {
+        lhs_offsets.push_back(batches.offset(0));
+        rhs_offsets.push_back(batches.offset(1));
+    }
 
-    extent batch_shape(count);
-    std::copy_n(std::begin(shape), count, std::begin(batch_shape));
-    return batch_shape;
-}
+    auto multiply = [&](index_t begin, index_t end) {
+        for (index_t b = begin; b < end; b++) {
+            detail::device_gemm(Device{}, m, n, k,
+                                detail::matrix_ref(lhs, lhs_offsets[b]),
+                                detail::matrix_ref(rhs, rhs_offsets[b]),
+                                detail::matrix_ref(result, b*m*n));
+        }
+    };
+
+    // with fewer batches than threads, or a BLAS that threads each product
+    // itself, the products run one after another
+    if (num_batches < index_t(num_threads()) || detail::device_gemm_threaded<T>(Device{})) {
+        multiply(0, num_batches);
+    } else {
+        parallel_for(0, num_batches, grain_size_for(m*n*k), multiply);
+    }
 
-inline extent calculate_batch_shape(extent const &shape, index_t d0, index_t d1) {
-    auto new_shape = get_batch_shape(shape);
-    new_shape.push_back(d0);
-    new_shape.push_back(d1);
-    return new_shape;
+    return result;
 }
 
+namespace detail {
+
 template <typename T, typename Device>
 Tensor<T, Device> product(Tensor<T, Device> const &lhs,
                           Tensor<T, Device> const &rhs)
@@ -465,35 +1196,25 @@ Tensor<T, Device> product(Tensor<T, Device> const &lhs,
     auto lhs_dims = num_dims(lhs);
     auto rhs_dims = num_dims(rhs);
 
-    // 5x3x6 * 5x
+    // batched: as in NumPy, a vector operand is treated as a single row
+    // (lhs) or column (rhs) of a matrix, and that dimension is dropped from
+    // the result
     if (lhs_dims > 2 || rhs_dims > 2) {
-        auto lhs_copy = lhs;
-        auto rhs_copy = rhs;
-
-        // flatten batch dimension if either tensor is > 3 dims
-        if (lhs_dims > 3) {
-            lhs_copy = reshape(lhs_copy, {expand, lhs.shape()[lhs_dims-2], lhs.shape()[lhs_dims-1]});
+        if (lhs_dims == 1) {
+            auto result = batch_matrix_matrix_product(reshape(lhs, {1, lhs.shape()[0]}), rhs);
+            auto shape = result.shape();
+            shape.erase(shape.end() - 2);
+            return reshape(result, shape);
         }
 
-        if (rhs_dims > 3) {
-            rhs_copy = reshape(rhs_copy, {expand, rhs.shape()[rhs_dims-2], rhs.shape()[rhs_dims-1]});
+        if (rhs_dims == 1) {
+            auto result = batch_matrix_matrix_product(lhs, reshape(rhs, {rhs.shape()[0], 1}));
+            auto shape = result.shape();
+            shape.pop_back();
+            return reshape(result, shape);
         }
 
-        // if (lhs_dims == 2) {
-        //     // add batch dimension
-        // } else if (lhs_dims == 1) {
-        //     // treat as batch matrix-vector multiplication
-        // }
-
-        // 2. either lhs or rhs > 3, in which case need to flatten
-        auto result = batch_matrix_matrix_product(lhs_copy, rhs_copy);
-
-        // for now, assume both lhs and rhs start off as the same shape
-        // auto new_shape = get_batch_size(orig_lhs_shape);
-        auto new_shape = calculate_batch_shape(lhs.shape(), result.shape()[1], result.shape()[2]);
-
-        // reshape into original batch dims
-        return reshape(result, new_shape);
+        return batch_matrix_matrix_product(lhs, rhs);
     }
 
     if (lhs_dims == 1 && rhs_dims == 1) {
@@ -514,6 +1235,21 @@ Tensor<T, Device> product(Tensor<T, Device> const &lhs,
     return matrix_matrix_product(lhs, rhs);
 }
 
+} // namespace detail
+
+template <typename T, typename Device>
+Tensor<T, Device> product(Tensor<T, Device> const &lhs,
+                          Tensor<T, Device> const &rhs)
+{
+    TENSOR_PROFILE_OP("product", (num_elements(lhs) + num_elements(rhs))*sizeof(T),
+                      lhs.shape(), rhs.shape());
+
+    auto result = detail::product(lhs, rhs);
+    TENSOR_PROFILE_ADD_BYTES(num_elements(result)*sizeof(T));
+
+    return result;
+}
+
 template <typename T, typename Device>
 Tensor<T, Device> operator *(Tensor<T, Device> const &lhs, Tensor<T, Device> const &rhs) {
     return product(lhs, rhs);
@@ -538,8 +1274,8 @@ Tensor<std::uint8_t, Device> operator !=(Tensor<T, Device> const &lhs,
 
 template <typename T, typename Device, typename F>
 bool all(Tensor<T, Device> const &op, F fn) {
-    for (auto const &index : op.indices()) {
-        if (!fn(op(index))) return false;
+    for (index_generator index(op.view()); !index.done(); index.next()) {
+        if (!fn(op.storage()[index.offset()])) return false;
     }
 
     return true;
@@ -547,8 +1283,8 @@ bool all(Tensor<T, Device> const &op, F fn) {
 
 template <typename T, typename Device, typename F>
 bool any(Tensor<T, Device> const &op, F fn) {
-    for (auto const &index : op.indices()) {
-        if (fn(op(index))) return true;
+    for (index_generator index(op.view()); !index.done(); index.next()) {
+        if (fn(op.storage()[index.offset()])) return true;
     }
 
     return false;
@@ -559,4 +1295,11 @@ bool equals(Tensor<T, Device> const &lhs, Tensor<T, Device> const &rhs) {
     return all(lhs == rhs, [](std::uint8_t v) { return v == true; });
 }
 
+template <typename L, typename R,
+          typename = std::enable_if_t<is_operand_v<L> && is_operand_v<R> &&
+                                      (is_expression_v<L> || is_expression_v<R>)>>
+bool equals(L const &lhs, R const &rhs) {
+    return equals(eval(lhs), eval(rhs));
+}
+
 #endif
\ No newline at end of file
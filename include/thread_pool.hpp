@@ -0,0 +1,243 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "types.hpp"
+
+/**
+ * @brief Fixed set of worker threads used to run `parallel_for` loops.
+ *
+ * A loop is split into chunks that workers (and the calling thread) claim
+ * one at a time from a shared counter, so faster threads pick up the slack
+ * of slower ones. Loops started from inside a parallel region, or while the
+ * pool is busy with another caller, run serially on the calling thread.
+ */
+class ThreadPool {
+public:
+    explicit ThreadPool(std::size_t num_threads) {
+        for (std::size_t i = 1; i < num_threads; i++) {
+            workers_.emplace_back([this] { work(); });
+        }
+    }
+
+    ThreadPool(ThreadPool const &) = delete;
+    ThreadPool &operator =(ThreadPool const &) = delete;
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+
+        wake_.notify_all();
+        for (auto &worker : workers_) {
+            worker.join();
+        }
+    }
+
+    /**
+     * @brief Number of threads that take part in a loop, including the caller
+     */
+    std::size_t num_threads() const { return workers_.size() + 1; }
+
+    /**
+     * @brief Calls `fn(chunk_begin, chunk_end)` over disjoint chunks covering
+     *        `begin` to `end`. Ranges of at most `grain` items run serially.
+     */
+    template <typename F>
+    void parallel_for(index_t begin, index_t end, index_t grain, F fn) {
+        if (end <= begin) return;
+
+        index_t size = end - begin;
+        grain = std::max<index_t>(grain, 1);
+
+        if (workers_.empty() || size <= grain || in_parallel_region()) {
+            fn(begin, end);
+            return;
+        }
+
+        std::unique_lock<std::mutex> run_lock(run_mutex_, std::try_to_lock);
+        if (!run_lock) {
+            fn(begin, end);
+            return;
+        }
+
+        // a few chunks per thread, so uneven chunks still balance out
+        Job job;
+        job.next = begin;
+        job.end = end;
+        job.chunk = std::max<index_t>(grain, size / (num_threads()*4));
+        job.context = &fn;
+        job.invoke = [](void *context, index_t chunk_begin, index_t chunk_end) {
+            (*static_cast<F *>(context))(chunk_begin, chunk_end);
+        };
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            job_ = &job;
+            ++generation_;
+        }
+
+        wake_.notify_all();
+        run(job);
+
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            job_ = nullptr;
+            done_.wait(lock, [&job] { return job.active == 0; });
+        }
+
+        if (job.error) std::rethrow_exception(job.error);
+    }
+private:
+    struct Job {
+        std::atomic<index_t> next;
+        index_t end;
+        index_t chunk;
+
+        void *context;
+        void (*invoke)(void *, index_t, index_t);
+
+        // number of workers currently running the job (guarded by mutex_)
+        std::size_t active = 0;
+
+        std::mutex error_mutex;
+        std::exception_ptr error;
+    };
+
+    static bool &in_parallel_region() {
+        thread_local bool in_region = false;
+        return in_region;
+    }
+
+    static void run(Job &job) {
+        in_parallel_region() = true;
+
+        while (true) {
+            index_t chunk_begin = job.next.fetch_add(job.chunk);
+            if (chunk_begin >= job.end) break;
+
+            index_t chunk_end = std::min(chunk_begin + job.chunk, job.end);
+
+            try {
+                job.invoke(job.context, chunk_begin, chunk_end);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(job.error_mutex);
+                if (!job.error) job.error = std::current_exception();
+            }
+        }
+
+        in_parallel_region() = false;
+    }
+
+    void work() {
+        std::uint64_t seen = 0;
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        while (true) {
+            wake_.wait(lock, [this, &seen] {
+                return stop_ || (job_ != nullptr && generation_ != seen);
+            });
+
+            if (stop_) return;
+
+            seen = generation_;
+            Job *job = job_;
+            ++job->active;
+
+            lock.unlock();
+            run(*job);
+            lock.lock();
+
+            if (--job->active == 0) done_.notify_all();
+        }
+    }
+
+    std::vector<std::thread> workers_;
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+
+    Job *job_ = nullptr;
+    std::uint64_t generation_ = 0;
+    bool stop_ = false;
+
+    // held by the thread whose loop is currently running on the pool
+    std::mutex run_mutex_;
+};
+
+/**
+ * @brief Number of threads used when none has been set: `TENSOR_NUM_THREADS`
+ *        if defined, otherwise the number of hardware threads
+ */
+inline std::size_t default_num_threads() {
+    if (auto env = std::getenv("TENSOR_NUM_THREADS")) {
+        auto num_threads = std::strtoul(env, nullptr, 10);
+        if (num_threads > 0) return num_threads;
+    }
+
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+namespace detail {
+
+inline std::unique_ptr<ThreadPool> &thread_pool_instance() {
+    static std::unique_ptr<ThreadPool> pool =
+        std::make_unique<ThreadPool>(default_num_threads());
+    return pool;
+}
+
+} // namespace detail
+
+/**
+ * @brief The pool used by tensor operations
+ */
+inline ThreadPool &thread_pool() {
+    return *detail::thread_pool_instance();
+}
+
+/**
+ * @brief Replaces the pool used by tensor operations. Must not be called
+ *        while operations are running.
+ */
+inline void set_num_threads(std::size_t num_threads) {
+    detail::thread_pool_instance() = std::make_unique<ThreadPool>(std::max<std::size_t>(num_threads, 1));
+}
+
+inline std::size_t num_threads() {
+    return thread_pool().num_threads();
+}
+
+/**
+ * @brief Minimum amount of work (roughly, elements touched) handed to a
+ *        single thread. Smaller operations run serially.
+ */
+inline index_t &parallel_grain_size() {
+    static index_t grain_size = 32768;
+    return grain_size;
+}
+
+/**
+ * @brief Grain, in items, for a loop where each item costs `work` elements
+ */
+inline index_t grain_size_for(index_t work) {
+    return std::max<index_t>(1, parallel_grain_size() / std::max<index_t>(work, 1));
+}
+
+template <typename F>
+void parallel_for(index_t begin, index_t end, index_t grain, F fn) {
+    thread_pool().parallel_for(begin, end, grain, fn);
+}
+
+#endif
@@ -4,19 +4,24 @@
 #include <vector>
 #include <numeric>
 
+#include "small_vector.hpp"
+
 using offset_t = std::size_t;
 using index_t = std::size_t;
 
+// dimensions stored inline before `extent`/`indices` allocate
+constexpr std::size_t max_inline_dims = 6;
+
 // make extent_t
-using extent = std::vector<index_t>;
+using extent = small_vector<index_t, max_inline_dims>;
 
 // make indices_t
-using indices = std::vector<index_t>;
+using indices = small_vector<index_t, max_inline_dims>;
 using index_range = std::pair<index_t, index_t>;
 
 inline std::size_t num_elements(const extent &shape) {
     return std::accumulate(
-        std::begin(shape), std::end(shape), 1, std::multiplies<>());
+        std::begin(shape), std::end(shape), std::size_t(1), std::multiplies<>());
 }
 
 #endif
\ No newline at end of file
@@ -8,6 +8,37 @@
 #include "index_generator.hpp"
 #include "stride_generator.hpp"
 
+TEST(IndexTestSuite, TestSmallVectorInline) {
+    extent shape = {2, 3, 4};
+    auto const *inline_data = shape.data();
+
+    shape.push_back(5);
+    shape.insert(shape.begin(), 1);
+    ASSERT_EQ((extent{1, 2, 3, 4, 5}), shape);
+    ASSERT_EQ(inline_data, shape.data());
+
+    extent copy(shape);
+    copy.erase(copy.begin());
+    ASSERT_EQ((extent{2, 3, 4, 5}), copy);
+    ASSERT_EQ(max_inline_dims, copy.capacity());
+}
+
+TEST(IndexTestSuite, TestSmallVectorSpills) {
+    indices values(max_inline_dims, 1);
+    for (index_t i = 0; i < 10; i++) values.push_back(values.back() + 1);
+
+    ASSERT_EQ(max_inline_dims + 10, values.size());
+    ASSERT_EQ(11u, values.back());
+
+    auto copy = values;
+    auto moved = std::move(values);
+    ASSERT_EQ(copy, moved);
+    ASSERT_TRUE(values.empty());
+
+    moved.resize(2);
+    ASSERT_EQ((indices{1, 1}), moved);
+}
+
 TEST(IndexTestSuite, TestMakeRowMajorOrder) {
     auto order = make_row_major_order(4);
 
@@ -349,4 +380,67 @@ TEST(IndexTestSuite, TestViewCalculateOffsetWithSingletons) {
         ASSERT_EQ(*expected_value, offset);
         ++expected_value;
     }
-}
\ No newline at end of file
+}
+
+TEST(IndexTestSuite, TestIndexGeneratorTracksOffsets) {
+    extent shape{3, 4, 5};
+    Layout layout(shape, make_strides(shape, make_row_major_order(shape.size())));
+
+    extent view_shape{2, 3, 4};
+    indices view_offset{1, 0, 1};
+    View view(layout, view_shape, view_offset, make_row_major_order(shape.size()));
+    View col_view(view_shape, make_col_major_order(view_shape.size()));
+
+    std::size_t count = 0;
+    for (index_generator index(view, col_view); !index.done(); index.next()) {
+        ASSERT_EQ(calculate_offset(view, index.read()), index.offset(0));
+        ASSERT_EQ(calculate_offset(col_view, index.read()), index.offset(1));
+        ++count;
+    }
+
+    ASSERT_EQ(num_elements(view_shape), count);
+}
+
+TEST(IndexTestSuite, TestCoalesceRowRange) {
+    // rows 1..3 of a 4x5 row-major matrix
+    extent shape{2, 5};
+    indices strides{5, 1};
+
+    auto loop = coalesce(shape, stride_order(strides), {strides});
+
+    ASSERT_EQ((extent{10}), loop.shape);
+    ASSERT_EQ((indices{1}), loop.strides[0]);
+}
+
+TEST(IndexTestSuite, TestCoalesceColumnRange) {
+    // columns 1..3 of a 4x5 row-major matrix, with a singleton dimension
+    extent shape{4, 1, 2};
+    indices strides{5, 5, 1};
+
+    auto loop = coalesce(shape, stride_order(strides), {strides});
+
+    ASSERT_EQ((extent{2, 4}), loop.shape);
+    ASSERT_EQ((indices{1, 5}), loop.strides[0]);
+}
+
+TEST(IndexTestSuite, TestCoalesceMixedOperands) {
+    extent shape{3, 4};
+    indices row_major{4, 1};
+    indices broadcast_rows{0, 1};
+
+    auto loop = coalesce(shape, stride_order(row_major), {row_major, broadcast_rows});
+
+    ASSERT_EQ((extent{4, 3}), loop.shape);
+    ASSERT_EQ((indices{1, 4}), loop.strides[0]);
+    ASSERT_EQ((indices{1, 0}), loop.strides[1]);
+}
+
+TEST(IndexTestSuite, TestCoalesceAllSingletons) {
+    extent shape{1, 1};
+    indices strides{1, 1};
+
+    auto loop = coalesce(shape, stride_order(strides), {strides});
+
+    ASSERT_EQ((extent{1}), loop.shape);
+    ASSERT_EQ((indices{0}), loop.strides[0]);
+}
@@ -0,0 +1,201 @@
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <fmt/format.h>
+#include <fmt/ranges.h>
+
+#include <range/v3/all.hpp>
+
+#include "tensor.hpp"
+#include "tensor_ops.hpp"
+#include "dlpack.hpp"
+#include "npy.hpp"
+
+#define ASSERT_TENSORS_EQ(expected, result) \
+    ASSERT_TRUE(equals(expected, result))
+
+TEST(InteropTestSuite, TestToDLPack) {
+    Tensor<float> t({2, 3, 4});
+    iota(t);
+
+    auto transposed = transpose(t, {2, 0, 1});
+    auto managed = to_dlpack(transposed);
+    auto const &dl_tensor = managed->dl_tensor;
+
+    ASSERT_EQ(kDLCPU, dl_tensor.device.device_type);
+    ASSERT_EQ(kDLFloat, dl_tensor.dtype.code);
+    ASSERT_EQ(32, dl_tensor.dtype.bits);
+    ASSERT_EQ(1, dl_tensor.dtype.lanes);
+    ASSERT_EQ(3, dl_tensor.ndim);
+    ASSERT_EQ(transposed.data(), dl_tensor.data);
+    ASSERT_EQ((std::vector<int64_t>{4, 2, 3}),
+              std::vector<int64_t>(dl_tensor.shape, dl_tensor.shape + 3));
+    ASSERT_EQ((std::vector<int64_t>{1, 12, 4}),
+              std::vector<int64_t>(dl_tensor.strides, dl_tensor.strides + 3));
+
+    // the export keeps the storage alive
+    auto storage = t.storage_ptr();
+    t = Tensor<float>({1});
+    transposed = t;
+    ASSERT_EQ(2, storage.use_count());
+
+    managed->deleter(managed);
+    ASSERT_EQ(1, storage.use_count());
+}
+
+TEST(InteropTestSuite, TestFromDLPack) {
+    Tensor<int> t({3, 4});
+    iota(t);
+
+    auto sliced = Tensor<int>(t[{1, 3}]);
+    auto imported = from_dlpack<int>(to_dlpack(sliced));
+
+    ASSERT_EQ(sliced.data(), imported.data());
+    ASSERT_TENSORS_EQ(sliced, imported);
+
+    // writes are shared
+    imported(0, 0) = -1;
+    ASSERT_EQ(-1, t(1, 0));
+
+    // a rejected tensor stays with the caller
+    auto managed = to_dlpack(sliced);
+    EXPECT_THROW(from_dlpack<float>(managed), UnsupportedDLPackTensor);
+    managed->deleter(managed);
+}
+
+TEST(InteropTestSuite, TestFromDLPackCompact) {
+    std::vector<double> values{0, 1, 2, 3, 4, 5, 6};
+    int64_t shape[] = {2, 3};
+    bool deleted = false;
+
+    DLManagedTensor managed{};
+    managed.dl_tensor.data = values.data();
+    managed.dl_tensor.device = {kDLCPU, 0};
+    managed.dl_tensor.ndim = 2;
+    managed.dl_tensor.dtype = dlpack_dtype<double>();
+    managed.dl_tensor.shape = shape;
+    managed.dl_tensor.strides = nullptr;
+    managed.dl_tensor.byte_offset = sizeof(double);
+    managed.manager_ctx = &deleted;
+    managed.deleter = [](DLManagedTensor *self) {
+        *static_cast<bool *>(self->manager_ctx) = true;
+    };
+
+    {
+        auto t = from_dlpack<double>(&managed);
+        ASSERT_EQ(1.0, t(0, 0));
+        ASSERT_EQ(5.0, t(1, 1));
+        ASSERT_EQ(6.0, t(1, 2));
+        ASSERT_FALSE(deleted);
+    }
+
+    ASSERT_TRUE(deleted);
+}
+
+TEST(InteropTestSuite, TestNpyRoundTrip) {
+    auto path = ::testing::TempDir() + "tensor_round_trip.npy";
+
+    Tensor<float> t({2, 3, 4});
+    iota(t);
+
+    save_npy(path, t);
+    ASSERT_TENSORS_EQ(t, load_npy<float>(path));
+    ASSERT_TENSORS_EQ(t, map_npy<float>(path));
+
+    // non-contiguous tensors are written in row-major order
+    auto transposed = transpose(t, {2, 0, 1});
+    save_npy(path, transposed);
+
+    auto loaded = load_npy<float>(path);
+    ASSERT_EQ((extent{4, 2, 3}), loaded.shape());
+    ASSERT_TRUE(loaded.contiguous());
+    ASSERT_TENSORS_EQ(transposed, loaded);
+
+    EXPECT_THROW(load_npy<double>(path), NpyError);
+    EXPECT_THROW(load_npy<float>(path + ".missing"), NpyError);
+}
+
+TEST(InteropTestSuite, TestNpyColumnMajor) {
+    auto path = ::testing::TempDir() + "tensor_column_major.npy";
+
+    Tensor<std::int64_t> t({3, 5}, TensorOrder::ColumnMajor);
+    iota(t);
+
+    save_npy(path, t);
+
+    for (auto const &loaded : {load_npy<std::int64_t>(path), map_npy<std::int64_t>(path)}) {
+        ASSERT_EQ(t.strides(), loaded.strides());
+        ASSERT_TENSORS_EQ(t, loaded);
+    }
+}
+
+TEST(InteropTestSuite, TestNpyForeignByteOrder) {
+    auto path = ::testing::TempDir() + "tensor_big_endian.npy";
+
+    // as written by numpy.save(path, numpy.array([1, 2, 258], dtype='>i4'))
+    std::string dict = "{'descr': '>i4', 'fortran_order': False, 'shape': (3,), }";
+    dict.append(128 - 10 - dict.size() - 1, ' ');
+    dict += '\n';
+
+    std::ofstream out(path, std::ios::binary);
+    out.write("\x93NUMPY\x01\x00", 8);
+    out.put(char(dict.size()));
+    out.put(0);
+    out << dict;
+    out.write("\0\0\0\x01\0\0\0\x02\0\0\x01\x02", 12);
+    out.close();
+
+    ASSERT_TENSORS_EQ((tensor<std::int32_t>({1, 2, 258})), load_npy<std::int32_t>(path));
+    EXPECT_THROW(map_npy<std::int32_t>(path), NpyError);
+}
+
+TEST(InteropTestSuite, TestNpyShapeTooLarge) {
+    auto path = ::testing::TempDir() + "tensor_too_large.npy";
+
+    // 2^61 * 8 elements of 4 bytes overflows std::size_t
+    std::string dict = "{'descr': '<f4', 'fortran_order': False, 'shape': (2305843009213693952, 8), }";
+    dict.append(128 - 10 - dict.size() - 1, ' ');
+    dict += '\n';
+
+    std::ofstream out(path, std::ios::binary);
+    out.write("\x93NUMPY\x01\x00", 8);
+    out.put(char(dict.size()));
+    out.put(0);
+    out << dict;
+    out.close();
+
+    auto expect_too_large = [&path](auto load) {
+        try {
+            load(path);
+            FAIL() << "loaded an array too large to address";
+        } catch (NpyError const &e) {
+            EXPECT_NE(std::string::npos, std::string(e.what()).find("shape too large"));
+        }
+    };
+
+    expect_too_large([](auto const &path) { return load_npy<float>(path); });
+    expect_too_large([](auto const &path) { return map_npy<float>(path); });
+}
+
+TEST(InteropTestSuite, TestNpz) {
+    auto path = ::testing::TempDir() + "tensor_arrays.npz";
+
+    auto a = tensor<double>({{1, 2}, {3, 4}});
+    auto b = transpose(tensor<double>({{1, 2, 3}, {4, 5, 6}}), {1, 0});
+    auto c = tensor<double>({7});
+
+    save_npz(path, std::map<std::string, Tensor<double>>{{"a", a}, {"b", b}, {"odd_name", c}});
+
+    for (auto const &arrays : {load_npz<double>(path), map_npz<double>(path)}) {
+        ASSERT_EQ(3, arrays.size());
+        ASSERT_TENSORS_EQ(a, arrays.at("a"));
+        ASSERT_TENSORS_EQ(b, arrays.at("b"));
+        ASSERT_TENSORS_EQ(c, arrays.at("odd_name"));
+    }
+
+    EXPECT_THROW(load_npz<float>(path), NpyError);
+}
@@ -0,0 +1,144 @@
+#include <sstream>
+
+#include <gtest/gtest.h>
+#include <fmt/format.h>
+#include <fmt/ranges.h>
+
+#include "tensor.hpp"
+#include "tensor_ops.hpp"
+#include "profile.hpp"
+
+// only built into TensorProfileTests, which defines TENSOR_PROFILE
+
+#define ASSERT_TENSORS_EQ(expected, result) \
+    ASSERT_TRUE(equals(expected, result))
+
+static std::vector<ProfileEvent> events_named(char const *name) {
+    std::vector<ProfileEvent> events;
+    for (auto const &event : profiler().events()) {
+        if (std::string(event.name) == name) events.push_back(event);
+    }
+
+    return events;
+}
+
+TEST(ProfileTestSuite, TestRecordsOps) {
+    auto a = tensor<float>({{1, 2, 3}, {4, 5, 6}});
+    auto b = tensor<float>({{1, 2}, {3, 4}, {5, 6}});
+
+    profiler().clear();
+    profiler().start();
+    auto c = a*b;
+    auto d = apply<float>(c, c, [](float x, float y) { return x + y; });
+    auto e = copy(transpose(a, {1, 0}));
+    profiler().stop();
+
+    // nothing is recorded once stopped
+    a*b;
+
+    auto products = events_named("product");
+    ASSERT_EQ(1u, products.size());
+    ASSERT_EQ((std::vector<extent>{{2, 3}, {3, 2}}), products[0].shapes);
+    ASSERT_EQ((6 + 6 + 4)*sizeof(float), products[0].bytes);
+    ASSERT_EQ(1u, products[0].allocations);
+
+    auto applies = events_named("apply");
+    ASSERT_EQ(1u, applies.size());
+    ASSERT_EQ(3*4*sizeof(float), applies[0].bytes);
+
+    auto copies = events_named("copy");
+    ASSERT_EQ(1u, copies.size());
+    ASSERT_EQ(2*6*sizeof(float), copies[0].bytes);
+
+    ASSERT_TENSORS_EQ(tensor<float>({{44, 56}, {98, 128}}), d);
+    ASSERT_TENSORS_EQ(transpose(a, {1, 0}), e);
+}
+
+TEST(ProfileTestSuite, TestRecordsExpressions) {
+    auto a = tensor<float>({{1, 2, 3}, {4, 5, 6}});
+    auto b = tensor<float>({1, 1, 1});
+
+    profiler().clear();
+    profiler().start();
+    Tensor<float> c = a + b - a;
+    c += a + b;
+    profiler().stop();
+
+    // operands broadcast inside an expression aren't recorded on their own
+    ASSERT_TRUE(events_named("broadcast_to").empty());
+
+    auto applies = events_named("apply");
+    ASSERT_EQ(1u, applies.size());
+    ASSERT_EQ((std::vector<extent>{{2, 3}, {3}, {2, 3}}), applies[0].shapes);
+    ASSERT_EQ(4*6*sizeof(float), applies[0].bytes);
+
+    auto iapplies = events_named("iapply");
+    ASSERT_EQ(1u, iapplies.size());
+    ASSERT_EQ((std::vector<extent>{{2, 3}, {3}}), iapplies[0].shapes);
+    ASSERT_EQ(4*6*sizeof(float), iapplies[0].bytes);
+
+    ASSERT_TENSORS_EQ(tensor<float>({{3, 4, 5}, {6, 7, 8}}), c);
+}
+
+TEST(ProfileTestSuite, TestNestedOps) {
+    auto v = tensor<float>({1, 2, 3});
+    Tensor<float> batch({4, 3, 2});
+
+    profiler().clear();
+    profiler().start();
+    auto result = v*batch;
+    profiler().stop();
+
+    // a vector times a batch reshapes both the vector and the result, inside
+    // the product
+    auto products = events_named("product");
+    auto reshapes = events_named("reshape");
+    ASSERT_EQ(1u, products.size());
+    ASSERT_EQ(2u, reshapes.size());
+
+    auto const &product = products[0];
+    for (auto const &reshape : reshapes) {
+        ASSERT_LE(product.start, reshape.start);
+        ASSERT_GE(product.start + product.duration, reshape.start + reshape.duration);
+    }
+
+    ASSERT_EQ(extent({4, 2}), result.shape());
+}
+
+TEST(ProfileTestSuite, TestChromeTrace) {
+    auto a = tensor({1, 2, 3});
+
+    profiler().clear();
+    profiler().start();
+    broadcast_to(a, {2, 3});
+    profiler().stop();
+
+    std::ostringstream trace;
+    profiler().write_chrome_trace(trace);
+
+    auto text = trace.str();
+    ASSERT_EQ(0u, text.find("{\"traceEvents\": ["));
+    ASSERT_NE(std::string::npos, text.find("\"name\": \"broadcast_to\""));
+    ASSERT_NE(std::string::npos, text.find("\"shapes\": \"[3] [2, 3]\""));
+    ASSERT_NE(std::string::npos, text.find("\"ph\": \"X\""));
+}
+
+TEST(ProfileTestSuite, TestSummary) {
+    Tensor<double> t({64, 64});
+
+    profiler().clear();
+    profiler().start();
+    for (int i = 0; i < 3; i++) {
+        iapply(t, [](double x) { return x + 1; });
+    }
+    profiler().stop();
+
+    auto summary = profiler().summary();
+    ASSERT_EQ(0u, summary.find("op"));
+
+    auto row = summary.find("\niapply");
+    ASSERT_NE(std::string::npos, row);
+    ASSERT_EQ(3, std::stoi(summary.substr(row + 17, 10)));
+
+    profiler().clear();
+}
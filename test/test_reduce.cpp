@@ -0,0 +1,141 @@
+#include <cmath>
+#include <limits>
+#include <random>
+
+#include <gtest/gtest.h>
+#include <fmt/format.h>
+#include <fmt/ranges.h>
+
+#include "tensor.hpp"
+#include "tensor_ops.hpp"
+#include "reduce.hpp"
+#include "thread_pool.hpp"
+
+#define ASSERT_TENSORS_EQ(expected, result) \
+    ASSERT_TRUE(equals(expected, result))
+
+TEST(ReduceTestSuite, TestSumAxes) {
+    Tensor<int> t({2, 3, 4});
+    iota(t);
+
+    ASSERT_TENSORS_EQ(tensor({{12, 14, 16, 18},
+                              {20, 22, 24, 26},
+                              {28, 30, 32, 34}}), sum(t, 0));
+
+    ASSERT_TENSORS_EQ(tensor({{12, 15, 18, 21},
+                              {48, 51, 54, 57}}), sum(t, 1));
+
+    ASSERT_TENSORS_EQ(tensor({{6, 22, 38},
+                              {54, 70, 86}}), sum(t, 2));
+
+    ASSERT_TENSORS_EQ(tensor({60, 92, 124}), sum(t, {0, 2}));
+
+    auto kept = sum(t, {0, 2}, true);
+    ASSERT_EQ(extent({1, 3, 1}), kept.shape());
+    ASSERT_EQ(92, kept(0, 1, 0));
+
+    ASSERT_TENSORS_EQ(tensor({276}), sum(t, {0, 1, 2}));
+    ASSERT_EQ(276, sum(t));
+}
+
+TEST(ReduceTestSuite, TestSumStrided) {
+    // reducing over the outer dimension accumulates whole rows at a time
+    Tensor<double> t({37, 300});
+    iota(t);
+
+    auto by_column = sum(t, 0);
+    auto by_row = sum(transpose(t, {1, 0}), 1);
+    for (index_t j = 0; j < 300; j++) {
+        double expected = 0;
+        for (index_t i = 0; i < 37; i++) expected += t(i, j);
+
+        ASSERT_EQ(expected, by_column(j));
+        ASSERT_EQ(expected, by_row(j));
+    }
+
+    auto permuted = transpose(reshape(t, {37, 20, 15}), {2, 0, 1});
+    ASSERT_TENSORS_EQ(sum(copy(permuted), {0, 2}), sum(permuted, {0, 2}));
+    ASSERT_TENSORS_EQ(sum(copy(permuted), 1), sum(permuted, 1));
+}
+
+TEST(ReduceTestSuite, TestMeanProdMaxMin) {
+    auto t = tensor({{1, 5, 3},
+                     {4, 2, 6}});
+
+    ASSERT_TENSORS_EQ(tensor({2.5, 3.5, 4.5}), mean(t, 0));
+    ASSERT_DOUBLE_EQ(3.5, mean(t));
+
+    ASSERT_TENSORS_EQ(tensor({15, 48}), prod(t, 1));
+    ASSERT_EQ(720, prod(t));
+
+    ASSERT_TENSORS_EQ(tensor({4, 5, 6}), max(t, 0));
+    ASSERT_TENSORS_EQ(tensor({1, 2}), min(t, 1));
+    ASSERT_EQ(6, max(t));
+    ASSERT_EQ(1, min(t));
+
+    auto nan = std::numeric_limits<float>::quiet_NaN();
+    auto f = tensor({1.0f, nan, 3.0f});
+    ASSERT_TRUE(std::isnan(max(f)));
+    ASSERT_TRUE(std::isnan(min(f)));
+}
+
+TEST(ReduceTestSuite, TestArgMax) {
+    auto t = tensor({{1, 7, 3, 7},
+                     {9, 2, 9, 0}});
+
+    ASSERT_TENSORS_EQ(tensor<index_t>({1, 0, 1, 0}), argmax(t, 0));
+    ASSERT_TENSORS_EQ(tensor<index_t>({1, 0}), argmax(t, 1));
+    ASSERT_TENSORS_EQ(tensor<index_t>({0, 3}), argmin(t, 1));
+    ASSERT_EQ(extent({2, 1}), argmax(t, 1, true).shape());
+
+    ASSERT_EQ(4u, argmax(t));
+    ASSERT_EQ(7u, argmin(t));
+    ASSERT_EQ(1u, argmax(transpose(t, {1, 0})));
+
+    // ties go to the first occurrence, across blocks reduced separately
+    Tensor<int> ones({5000});
+    fill(ones, 1);
+    ones(3000) = 2;
+    ones(4000) = 2;
+    ASSERT_EQ(3000u, argmax(ones));
+}
+
+TEST(ReduceTestSuite, TestInvalidReductions) {
+    Tensor<int> t({2, 3});
+
+    ASSERT_THROW(sum(t, 2), InvalidAxes);
+    ASSERT_THROW(sum(t, {1, 1}), InvalidAxes);
+
+    Tensor<int> empty({2, 0});
+    ASSERT_TENSORS_EQ(tensor({0, 0}), sum(empty, 1));
+    ASSERT_THROW(max(empty, 1), EmptyReduction);
+}
+
+TEST(ReduceTestSuite, TestPairwiseSum) {
+    Tensor<float> t({1 << 22});
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+    for (index_t i = 0; i < num_elements(t); i++) {
+        t(i) = distribution(generator);
+    }
+
+    double expected = 0;
+    for (index_t i = 0; i < num_elements(t); i++) expected += t(i);
+
+    // accumulating four million floats one at a time loses about three digits
+    float result = sum(t);
+    ASSERT_NEAR(1.0, result/expected, 1e-6);
+
+    // the order of additions only depends on the tensor, not on the threads
+    auto grain_size = parallel_grain_size();
+    parallel_grain_size() = 1;
+
+    auto rows = reshape(t, {1 << 11, 1 << 11});
+    auto serial_rows = sum(rows, 0);
+    set_num_threads(4);
+    ASSERT_EQ(result, sum(t));
+    ASSERT_TENSORS_EQ(serial_rows, sum(rows, 0));
+    set_num_threads(default_num_threads());
+
+    parallel_grain_size() = grain_size;
+}
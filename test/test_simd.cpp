@@ -0,0 +1,73 @@
+#include <cmath>
+
+#include <gtest/gtest.h>
+#include <fmt/format.h>
+#include <fmt/ranges.h>
+
+#include "tensor.hpp"
+#include "tensor_ops.hpp"
+#include "reduce.hpp"
+#include "simd.hpp"
+
+#define ASSERT_TENSORS_EQ(expected, result) \
+    ASSERT_TRUE(equals(expected, result))
+
+TEST(SimdTestSuite, TestParseLevel) {
+    SimdLevel level = SimdLevel::Generic;
+
+    ASSERT_TRUE(parse_simd_level("avx2", level));
+    ASSERT_EQ(SimdLevel::AVX2, level);
+    ASSERT_TRUE(parse_simd_level("sse4.2", level));
+    ASSERT_EQ(SimdLevel::SSE42, level);
+
+    ASSERT_FALSE(parse_simd_level("avx1024", level));
+    ASSERT_EQ(SimdLevel::SSE42, level);
+}
+
+TEST(SimdTestSuite, TestSetLevel) {
+    auto level = simd_level();
+
+    // levels the CPU lacks are capped rather than crashing
+    ASSERT_EQ(detect_simd_level(), set_simd_level(SimdLevel::AVX512));
+    ASSERT_EQ(SimdLevel::Generic, set_simd_level(SimdLevel::Generic));
+    ASSERT_EQ(SimdLevel::Generic, simd_level());
+
+    set_simd_level(level);
+}
+
+TEST(SimdTestSuite, TestLevelsAgree) {
+    auto level = simd_level();
+
+    Tensor<float> x({37, 41});
+    Tensor<int> lhs({33, 17});
+    Tensor<int> rhs({17, 29});
+    iota(x, -5.0f, 0.01f);
+    iota(lhs);
+    iota(rhs);
+
+    set_simd_level(SimdLevel::Generic);
+    auto expected_exp = exp(x);
+    auto expected_sum = sum(x, 0);
+    auto expected_product = lhs*rhs;
+    auto expected_sigmoid = sigmoid(transpose(x, {1, 0}));
+
+    for (auto forced : {SimdLevel::SSE42, SimdLevel::AVX2, SimdLevel::AVX512}) {
+        set_simd_level(forced);
+
+        auto result_exp = exp(x);
+        auto result_sigmoid = sigmoid(transpose(x, {1, 0}));
+        for (index_t i = 0; i < 37; i++) {
+            for (index_t j = 0; j < 41; j++) {
+                // fused multiply-adds may round differently
+                ASSERT_NEAR(expected_exp(i, j), result_exp(i, j), 1e-6f*expected_exp(i, j));
+                ASSERT_NEAR(expected_sigmoid(j, i), result_sigmoid(j, i), 1e-6f);
+            }
+        }
+
+        // sums are added in the same order at every level
+        ASSERT_TENSORS_EQ(expected_sum, sum(x, 0));
+        ASSERT_TENSORS_EQ(expected_product, lhs*rhs);
+    }
+
+    set_simd_level(level);
+}
@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+#include <fmt/format.h>
+#include <fmt/ranges.h>
+
+#include "tensor.hpp"
+#include "tensor_ops.hpp"
+#include "static_tensor.hpp"
+
+#define ASSERT_TENSORS_EQ(expected, result) \
+    ASSERT_TRUE(equals(expected, result))
+
+TEST(StaticTensorTestSuite, TestRankedTensorIndexing) {
+    RankedTensor<int, 2> points({4, 3});
+    ASSERT_EQ(12u, points.num_elements());
+    ASSERT_EQ((std::array<index_t, 2>{3, 1}), points.strides());
+
+    for (index_t i = 0; i < 4; i++) {
+        for (index_t j = 0; j < 3; j++) points(i, j) = i*3 + j;
+    }
+
+    Tensor<int> expected({4, 3});
+    iota(expected);
+    ASSERT_TENSORS_EQ(expected, points.tensor());
+}
+
+TEST(StaticTensorTestSuite, TestRankedTensorSharesStorage) {
+    Tensor<int> t({2, 3, 4});
+    iota(t);
+
+    auto transposed = transpose(t, {2, 0, 1});
+    RankedTensor<int, 3> ranked(transposed);
+    ASSERT_EQ((std::array<index_t, 3>{4, 2, 3}), ranked.shape());
+
+    for (index_t i = 0; i < 4; i++) {
+        for (index_t j = 0; j < 2; j++) {
+            for (index_t k = 0; k < 3; k++) ASSERT_EQ(transposed(i, j, k), ranked(i, j, k));
+        }
+    }
+
+    ranked(3, 1, 2) = -1;
+    ASSERT_EQ(-1, t(1, 2, 3));
+    ASSERT_TENSORS_EQ(transposed, ranked.tensor());
+
+    ASSERT_THROW((RankedTensor<int, 2>(t)), MismatchedRank);
+}
+
+TEST(StaticTensorTestSuite, TestStaticTensorLayout) {
+    using Mat = StaticTensor<float, 2, 3, 4>;
+    static_assert(Mat::size == 24);
+    static_assert(Mat::strides()[0] == 12 && Mat::strides()[1] == 4 && Mat::strides()[2] == 1);
+    static_assert(sizeof(Mat) == 24*sizeof(float));
+
+    constexpr StaticTensor<int, 2, 2> m({1, 2, 3, 4});
+    static_assert(m(1, 0) == 3);
+}
+
+TEST(StaticTensorTestSuite, TestStaticTensorConversion) {
+    Tensor<int> t({3, 2});
+    iota(t);
+
+    StaticTensor<int, 2, 3> m(transpose(t, {1, 0}));
+    ASSERT_EQ((StaticTensor<int, 2, 3>({0, 2, 4, 1, 3, 5})), m);
+    ASSERT_TENSORS_EQ(transpose(t, {1, 0}), m.tensor());
+
+    ASSERT_THROW((StaticTensor<int, 3, 3>(t)), MismatchedDimensions);
+}
+
+TEST(StaticTensorTestSuite, TestStaticTensorArithmetic) {
+    StaticTensor<int, 2, 3> a({1, 2, 3, 4, 5, 6});
+    StaticTensor<int, 3, 2> b({1, 0, 0, 1, 1, 1});
+
+    ASSERT_EQ((StaticTensor<int, 2, 2>({4, 5, 10, 11})), a*b);
+    ASSERT_EQ((StaticTensor<int, 2>({14, 32})), (a*StaticTensor<int, 3>({1, 2, 3})));
+    ASSERT_EQ(b, transpose(StaticTensor<int, 2, 3>({1, 0, 1, 0, 1, 1})));
+
+    ASSERT_EQ((StaticTensor<int, 2, 3>({2, 4, 6, 8, 10, 12})), a + a);
+    ASSERT_EQ((StaticTensor<int, 2, 3>{}), a - a);
+    ASSERT_EQ(a + a, 2*a);
+}
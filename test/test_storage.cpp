@@ -1,9 +1,16 @@
+#include <cstdint>
+#include <fstream>
+#include <numeric>
+#include <string>
+#include <thread>
+
 #include <gtest/gtest.h>
 #include <fmt/format.h>
 #include <fmt/ranges.h>
 
 #include <range/v3/all.hpp>
 
+#include "mapped_file.hpp"
 #include "storage.hpp"
 
 template <typename T>
@@ -34,4 +41,153 @@ TYPED_TEST(StorageTestSuite, TestCPUCreate) {
     for (index_t i = 0; i < storage.size(); i++) {
         ASSERT_EQ(2, storage[i]);
     }
-}
\ No newline at end of file
+}
+
+TYPED_TEST(StorageTestSuite, TestCPUAligned) {
+    for (std::size_t size : {1, 3, 17, 1000}) {
+        Storage<TypeParam, CPU> storage(size);
+        Storage<TypeParam, CPU> uninitialized_storage(size, uninitialized);
+
+        ASSERT_EQ(size, uninitialized_storage.size());
+
+        auto address = reinterpret_cast<std::uintptr_t>(storage.data());
+        ASSERT_EQ(0, address % TENSOR_STORAGE_ALIGNMENT);
+
+        address = reinterpret_cast<std::uintptr_t>(uninitialized_storage.data());
+        ASSERT_EQ(0, address % TENSOR_STORAGE_ALIGNMENT);
+    }
+}
+
+TEST(CachingAllocatorTestSuite, TestBucketSize) {
+    auto alignment = CachingAllocator::alignment;
+
+    ASSERT_EQ(alignment, CachingAllocator::bucket_size(1));
+    ASSERT_EQ(alignment, CachingAllocator::bucket_size(alignment));
+
+    for (std::size_t bytes : {65, 100, 1000, 4097, 123456, 1 << 30}) {
+        auto size = CachingAllocator::bucket_size(bytes);
+        ASSERT_LE(bytes, size);
+        ASSERT_LE(size, bytes + bytes/4 + alignment);
+        ASSERT_EQ(0, size % alignment);
+        ASSERT_EQ(size, CachingAllocator::bucket_size(size));
+    }
+}
+
+TEST(CachingAllocatorTestSuite, TestReuse) {
+    auto &allocator = caching_allocator();
+    allocator.trim();
+
+    auto before = allocator.stats();
+    ASSERT_EQ(0, before.bytes_cached);
+
+    float const *address;
+    {
+        Storage<float, CPU> storage(1000);
+        address = storage.data();
+    }
+
+    auto freed = allocator.stats();
+    ASSERT_EQ(CachingAllocator::bucket_size(1000*sizeof(float)), freed.bytes_cached);
+
+    {
+        // the same bucket is handed out again
+        Storage<float, CPU> storage(990, uninitialized);
+        ASSERT_EQ(address, storage.data());
+
+        auto reused = allocator.stats();
+        ASSERT_EQ(freed.hits + 1, reused.hits);
+        ASSERT_EQ(freed.misses, reused.misses);
+        ASSERT_EQ(0, reused.bytes_cached);
+    }
+
+    allocator.trim();
+    ASSERT_EQ(0, allocator.stats().bytes_cached);
+}
+
+TEST(CachingAllocatorTestSuite, TestThreadExit) {
+    auto &allocator = caching_allocator();
+    allocator.trim();
+
+    // blocks cached by a thread are shared when it exits
+    std::thread([] { Storage<double, CPU> storage(777); }).join();
+    ASSERT_EQ(CachingAllocator::bucket_size(777*sizeof(double)), allocator.stats().bytes_cached);
+
+    auto hits = allocator.stats().hits;
+    Storage<double, CPU> storage(777);
+    ASSERT_EQ(hits + 1, allocator.stats().hits);
+
+    allocator.trim();
+}
+
+TEST(CachingAllocatorTestSuite, TestDisabled) {
+    auto &allocator = caching_allocator();
+    allocator.trim();
+    allocator.set_enabled(false);
+
+    { Storage<int, CPU> storage(100); }
+    ASSERT_EQ(0, allocator.stats().bytes_cached);
+
+    allocator.set_enabled(true);
+}
+
+namespace {
+
+std::string write_range_file(std::string const &name, std::size_t count) {
+    auto path = ::testing::TempDir() + name;
+
+    std::vector<float> values(count);
+    std::iota(values.begin(), values.end(), 0.0f);
+
+    std::ofstream file(path, std::ios::binary);
+    file.write(reinterpret_cast<char const *>(values.data()), count*sizeof(float));
+    return path;
+}
+
+float read_float(std::string const &path, std::size_t i) {
+    std::ifstream file(path, std::ios::binary);
+    file.seekg(i*sizeof(float));
+
+    float value;
+    file.read(reinterpret_cast<char *>(&value), sizeof(float));
+    return value;
+}
+
+} // namespace
+
+TEST(MappedStorageTestSuite, TestReadOnly) {
+    auto path = write_range_file("tensor_mapped_ro.bin", 24);
+
+    auto t = map_tensor<float>(path, {2, 3, 4}, MapMode::ReadOnly, MapAccess::Sequential);
+    ASSERT_EQ((extent{2, 3, 4}), t.shape());
+    ASSERT_EQ(23.0f, t(1, 2, 3));
+    ASSERT_EQ(6.0f, t(0, 1, 2));
+
+    // offset by one row, column major
+    auto t2 = map_tensor<float>(path, {4, 5}, MapMode::ReadOnly, MapAccess::Random,
+                                4*sizeof(float), TensorOrder::ColumnMajor);
+    ASSERT_EQ(4.0f, t2(0, 0));
+    ASSERT_EQ(5.0f, t2(1, 0));
+    ASSERT_EQ(8.0f, t2(0, 1));
+
+    EXPECT_THROW(map_tensor<float>(path, {5, 5}), std::out_of_range);
+    EXPECT_THROW(map_tensor<float>(path, {2}, MapMode::ReadOnly, MapAccess::Normal, 2),
+                 std::invalid_argument);
+    EXPECT_THROW(map_tensor<float>(path + ".missing", {1}), std::system_error);
+}
+
+TEST(MappedStorageTestSuite, TestWrite) {
+    auto path = write_range_file("tensor_mapped_rw.bin", 12);
+
+    {
+        auto t = map_tensor<float>(path, {3, 4}, MapMode::CopyOnWrite);
+        t(1, 1) = -1.0f;
+        ASSERT_EQ(-1.0f, t(1, 1));
+    }
+    ASSERT_EQ(5.0f, read_float(path, 5));
+
+    {
+        auto t = map_tensor<float>(path, {3, 4}, MapMode::ReadWrite);
+        t(1, 1) = -1.0f;
+    }
+    ASSERT_EQ(-1.0f, read_float(path, 5));
+}
@@ -1,3 +1,6 @@
+#include <numeric>
+#include <vector>
+
 #include <gtest/gtest.h>
 #include <fmt/format.h>
 #include <fmt/ranges.h>
@@ -89,6 +92,56 @@ TEST(TensorTestSuite, TestSliceTensor) {
     }
 }
 
+TEST(TensorTestSuite, TestSliceBorrowsStorage) {
+    Tensor<int> t({3, 4, 5});
+    iota(t);
+    ASSERT_EQ(1, t.storage_ptr().use_count());
+
+    auto slice = t[1][2];
+    ASSERT_EQ(1, t.storage_ptr().use_count());
+    ASSERT_EQ(&t.storage(), &slice.storage());
+
+    Tensor<int> row = slice[{1, 3}];
+    ASSERT_EQ(2, t.storage_ptr().use_count());
+    ASSERT_EQ(31, row(0, 0, 0));
+
+    Tensor<int> moved = std::move(row);
+    ASSERT_EQ(2, t.storage_ptr().use_count());
+}
+
+TEST(TensorTestSuite, TestSliceOwnsStorageOfRvalue) {
+    Tensor<int> t({3, 4});
+    iota(t);
+
+    // the transposed tensor is gone before the slice is used
+    auto column = transpose(t, {1, 0})[1];
+    ASSERT_EQ(2, t.storage_ptr().use_count());
+
+    Tensor<int> kept = column;
+    ASSERT_TENSORS_EQ(tensor({{1, 5, 9}}), kept);
+
+    auto moved = std::move(t)[{1, 3}][1];
+    t = Tensor<int>({1});
+
+    Tensor<int> block = moved;
+    ASSERT_EQ((extent{2, 1}), block.shape());
+    ASSERT_EQ(5, block(0, 0));
+    ASSERT_EQ(9, block(1, 0));
+}
+
+TEST(TensorTestSuite, TestCheckedIndexing) {
+    Tensor<int> t({3, 4, 5});
+    iota(t);
+
+    Tensor<int> sliced = transpose(t, {2, 0, 1})[{1, 3}];
+    ASSERT_EQ(t(2, 3, 1), sliced.at(0, 2, 3));
+    ASSERT_EQ(&sliced(1, 2, 3), &sliced.at_unchecked(1, 2, 3));
+    ASSERT_EQ(t(2, 3, 2), sliced.at(1, 2, 3));
+
+    ASSERT_THROW(sliced.at(2, 0, 0), std::out_of_range);
+    ASSERT_THROW(sliced.at(0, 0), std::out_of_range);
+}
+
 TEST(TensorTestSuite, TestSliceRangeTensor) {
     Tensor<int> t({5, 3});
     fill_tensor(t);
@@ -201,7 +254,7 @@ TEST(TensorTestSuite, TestTranspose) {
              {20,  21, 22,  23}}
         });
 
-        ASSERT_EQ((std::vector{4ul, 12ul, 1ul}), t2.view().strides);
+        ASSERT_EQ((indices{4ul, 12ul, 1ul}), t2.view().strides);
         ASSERT_TENSORS_EQ(expected, t2);
     }
 
@@ -220,7 +273,7 @@ TEST(TensorTestSuite, TestTranspose) {
              {15, 19, 23}}
         });
 
-        ASSERT_EQ((std::vector{12ul, 1ul, 4ul}), t2.view().strides);
+        ASSERT_EQ((indices{12ul, 1ul, 4ul}), t2.view().strides);
         ASSERT_TENSORS_EQ(expected, t2);
     }
 
@@ -244,7 +297,7 @@ TEST(TensorTestSuite, TestTranspose) {
              {11, 23}}
         });
 
-        ASSERT_EQ((std::vector{4ul, 1ul, 12ul}), t2.view().strides);
+        ASSERT_EQ((indices{4ul, 1ul, 12ul}), t2.view().strides);
         ASSERT_TENSORS_EQ(expected, t2);
     }
 }
@@ -268,7 +321,7 @@ TEST(TensorTestSuite, TestTransposeWithView) {
              {20, 21}},
         });
 
-        ASSERT_EQ((std::vector{4ul, 12ul, 1ul}), t3.view().strides);
+        ASSERT_EQ((indices{4ul, 12ul, 1ul}), t3.view().strides);
         ASSERT_TENSORS_EQ(expected, t3);
     }
 
@@ -287,7 +340,7 @@ TEST(TensorTestSuite, TestTransposeWithView) {
              {21, 22}},
         });
 
-        ASSERT_EQ((std::vector{4ul, 12ul, 1ul}), t3.view().strides);
+        ASSERT_EQ((indices{4ul, 12ul, 1ul}), t3.view().strides);
         ASSERT_TENSORS_EQ(expected, t3);
     }
 
@@ -392,3 +445,99 @@ TEST(TensorTestSuite, TestFormatTensor4d_1) {
     fmt::format_to(buffer, "{}", t);
     ASSERT_EQ(fmt::to_string(buffer), expected);
 }
+
+TEST(TensorTestSuite, TestFromBuffer) {
+    std::vector<int> buffer(12);
+    std::iota(buffer.begin(), buffer.end(), 0);
+
+    auto t = from_buffer(buffer.data(), {3, 4});
+    ASSERT_EQ(buffer.data(), t.data());
+    ASSERT_EQ(7, t(1, 3));
+
+    // writes go straight to the buffer
+    t(2, 0) = -1;
+    ASSERT_EQ(-1, buffer[8]);
+
+    // every other column, read as a 3x2 tensor
+    auto columns = from_buffer(buffer.data() + 1, {3, 2}, {4, 2});
+    ASSERT_TENSORS_EQ((tensor({{1, 3}, {5, 7}, {9, 11}})), columns);
+
+    // column-major strides
+    auto transposed = from_buffer(buffer.data(), {4, 3}, {1, 4});
+    ASSERT_EQ(6, transposed(2, 1));
+    ASSERT_FALSE(transposed.contiguous());
+}
+
+TEST(TensorTestSuite, TestFromBufferDeleter) {
+    int deleted = 0;
+    auto data = new float[6]();
+
+    {
+        auto t = from_buffer(data, {2, 3}, {3, 1}, [&deleted](float *p) {
+            ++deleted;
+            delete[] p;
+        });
+
+        auto alias = t;
+        t = Tensor<float>({1});
+        ASSERT_EQ(0, deleted);
+    }
+
+    ASSERT_EQ(1, deleted);
+}
+
+TEST(TensorTestSuite, TestExportBuffer) {
+    Tensor<int> t({3, 4, 5});
+    iota(t);
+
+    Tensor<int> sliced = transpose(t, {2, 0, 1})[1];
+    ASSERT_EQ(&sliced(0, 0, 0), sliced.data());
+
+    // a tensor rebuilt from the exported pointer, shape and strides aliases
+    // the same elements
+    auto alias = from_buffer(sliced.data(), sliced.shape(), sliced.strides());
+    ASSERT_TENSORS_EQ(sliced, alias);
+}
+
+TEST(TensorTestSuite, TestFormatSummarized) {
+    Tensor<int> t({6, 6});
+    fill_tensor(t);
+
+    FormatOptions options;
+    options.threshold = 10;
+    options.edge_items = 2;
+
+    std::string expected = "[[  0,   1, ...,   4,   5],\n"
+                           " [  6,   7, ...,  10,  11],\n"
+                           " ...,\n"
+                           " [ 24,  25, ...,  28,  29],\n"
+                           " [ 30,  31, ...,  34,  35]]";
+
+    std::string result;
+    format_tensor(std::back_inserter(result), t, options);
+    ASSERT_EQ(expected, result);
+
+    // strided tensors are summarized the same way
+    result.clear();
+    format_tensor(std::back_inserter(result), transpose(t, {1, 0}), options);
+    ASSERT_EQ("[[  0,   6, ...,  24,  30],\n"
+              " [  1,   7, ...,  25,  31],\n"
+              " ...,\n"
+              " [  4,  10, ...,  28,  34],\n"
+              " [  5,  11, ...,  29,  35]]", result);
+
+    // the default options summarize tensors of over 1000 elements
+    auto large = range<int>(0, 2000);
+    ASSERT_EQ("[  0,   1,   2, ..., 1997, 1998, 1999]", fmt::format("{}", large));
+}
+
+TEST(TensorTestSuite, TestFormatPrecision) {
+    auto t = tensor<double>({0.5, 1.0/3, 2});
+
+    FormatOptions options;
+    options.precision = 2;
+
+    std::string result;
+    format_tensor(std::back_inserter(result), t, options);
+    ASSERT_EQ("[0.50, 0.33, 2.00]", result);
+}
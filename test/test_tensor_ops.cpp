@@ -1,3 +1,6 @@
+#include <cmath>
+#include <limits>
+
 #include <gtest/gtest.h>
 #include <fmt/format.h>
 #include <fmt/ranges.h>
@@ -31,8 +34,8 @@ TEST(TensorOpsTestSuite, TestReshape) {
         auto expected = tensor({ 0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11,
                                 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23});
 
-        ASSERT_EQ((std::vector{24UL}), t2.shape());
-        ASSERT_EQ((std::vector{1UL}), t2.view().strides);
+        ASSERT_EQ((extent{24UL}), t2.shape());
+        ASSERT_EQ((indices{1UL}), t2.view().strides);
         ASSERT_TENSORS_EQ(expected, t2);
 
         // contiguous, so should have same memory address
@@ -51,8 +54,8 @@ TEST(TensorOpsTestSuite, TestReshape) {
             { 20,  21,  22,  23}
         });
 
-        ASSERT_EQ((std::vector{6UL, 4UL}), t2.shape());
-        ASSERT_EQ((std::vector{4UL, 1UL}), t2.view().strides);
+        ASSERT_EQ((extent{6UL, 4UL}), t2.shape());
+        ASSERT_EQ((indices{4UL, 1UL}), t2.view().strides);
         ASSERT_TENSORS_EQ(expected, t2);
 
         // contiguous, so should have same memory address
@@ -70,8 +73,8 @@ TEST(TensorOpsTestSuite, TestReshape) {
         });
 
 
-        ASSERT_EQ((std::vector{4UL, 6UL}), t2.shape());
-        ASSERT_EQ((std::vector{6UL, 1UL}), t2.view().strides);
+        ASSERT_EQ((extent{4UL, 6UL}), t2.shape());
+        ASSERT_EQ((indices{6UL, 1UL}), t2.view().strides);
         ASSERT_TENSORS_EQ(expected, t2);
 
         // contiguous, so should have same memory address
@@ -106,6 +109,19 @@ TEST(TensorOpTestSuite, TestReshapeWithNonContiguousTensor) {
     ASSERT_NE(t3.storage_ptr(), t2.storage_ptr());
 }
 
+TEST(TensorOpTestSuite, TestReshapeSliced) {
+    Tensor<int> t({3, 4});
+    iota(t);
+
+    Tensor<int> block = t[{0, 3}][{1, 3}];
+    ASSERT_TENSORS_EQ(tensor({1, 2, 5, 6, 9, 10}), reshape(block, {6}));
+
+    Tensor<int> row = t[1];
+    auto flat_row = reshape(row, {4});
+    ASSERT_TENSORS_EQ(tensor({4, 5, 6, 7}), flat_row);
+    ASSERT_EQ(t.storage_ptr(), flat_row.storage_ptr());
+}
+
 TEST(TensorOpTestSuite, TestReshapeWithInferredDimension) {
     Tensor<int> t({2, 3, 4});
     iota(t);
@@ -211,6 +227,26 @@ TEST(TensorOpsTestSuite, TestBroadcast3) {
     ASSERT_TENSORS_EQ(expected, result);
 }
 
+TEST(TensorOpsTestSuite, TestViewsOfSlicesKeepBaseOffset) {
+    Tensor<int> t({3, 4});
+    iota(t);
+
+    Tensor<int> row = t[2];
+    ASSERT_EQ(8u, row.view().base);
+
+    auto broadcast = broadcast_to(row, {2, 3, 4});
+    ASSERT_EQ(row.view().base, broadcast.view().base);
+    ASSERT_EQ(8, broadcast(0, 0, 0));
+    ASSERT_EQ(11, broadcast(1, 2, 3));
+
+    auto flat = reshape(row, {4});
+    ASSERT_TENSORS_EQ(tensor({8, 9, 10, 11}), flat);
+
+    Tensor<int> column = transpose(t, {1, 0})[{1, 3}];
+    ASSERT_EQ(t.view().strides[1], column.view().base);
+    ASSERT_EQ(t(2, 2), column(1, 2));
+}
+
 TEST(TensorOpsTestSuite, TestAddTensors1) {
     auto lhs = tensor({1, 2, 3});
     auto rhs = tensor({1, 1, 1});
@@ -568,4 +604,350 @@ TEST(TensorOpsTestSuite, TestSin) {
 
     auto t2 = sin(t);
     ASSERT_TENSORS_EQ(expected, t2);
-}
\ No newline at end of file
+}
+
+TEST(TensorOpsTestSuite, TestUnaryMath) {
+    Tensor<float> t({40, 50});
+    for (index_t i = 0; i < 40; i++) {
+        for (index_t j = 0; j < 50; j++) {
+            t(i, j) = -10.0f + 20.0f*float(i*50 + j)/2000.0f;
+        }
+    }
+
+    Tensor<float> positive = apply<float>(t, [](float v) { return std::abs(v) + 1e-3f; });
+    auto transposed = transpose(t, {1, 0});
+
+    auto check = [](auto const &input, auto const &result, auto reference, float tolerance) {
+        ASSERT_EQ(input.shape(), result.shape());
+        for (index_t i = 0; i < input.shape()[0]; i++) {
+            for (index_t j = 0; j < input.shape()[1]; j++) {
+                double expected = reference(double(input(i, j)));
+                ASSERT_NEAR(expected, result(i, j), tolerance*std::max(1.0, std::abs(expected)));
+            }
+        }
+    };
+
+    check(t, exp(t), [](double v) { return std::exp(v); }, 3e-7f);
+    check(positive, log(positive), [](double v) { return std::log(v); }, 3e-7f);
+    check(t, tanh(t), [](double v) { return std::tanh(v); }, 3e-7f);
+    check(t, sigmoid(t), [](double v) { return 1/(1 + std::exp(-v)); }, 3e-7f);
+    check(positive, sqrt(positive), [](double v) { return std::sqrt(v); }, 3e-7f);
+    check(positive, rsqrt(positive), [](double v) { return 1/std::sqrt(v); }, 3e-7f);
+    check(t, sin(t), [](double v) { return std::sin(v); }, 3e-7f);
+    check(t, cos(t), [](double v) { return std::cos(v); }, 3e-7f);
+    check(t, erf(t), [](double v) { return std::erf(v); }, 5e-7f);
+
+    // strided input takes the buffered path
+    check(transposed, exp(transposed), [](double v) { return std::exp(v); }, 3e-7f);
+    check(transposed, cos(transposed), [](double v) { return std::cos(v); }, 3e-7f);
+
+    Tensor<float> in_place = copy(transposed);
+    itanh(in_place);
+    ASSERT_TENSORS_EQ(tanh(transposed), in_place);
+
+    // special values
+    auto inf = std::numeric_limits<float>::infinity();
+    auto special = tensor({-inf, -1.0f, 0.0f, inf, 1e5f});
+    auto logs = log(special);
+    ASSERT_TRUE(std::isnan(logs(0)) && std::isnan(logs(1)));
+    ASSERT_EQ(-inf, logs(2));
+    ASSERT_EQ(inf, logs(3));
+    auto exps = exp(special);
+    ASSERT_EQ(0.0f, exps(0));
+    ASSERT_FLOAT_EQ(std::exp(-1.0f), exps(1));
+    ASSERT_EQ(1.0f, exps(2));
+    ASSERT_EQ(inf, exps(3));
+    ASSERT_EQ(inf, exps(4));
+    ASSERT_FLOAT_EQ(std::sin(1e5f), sin(special)(4));
+
+    // other element types use the standard library
+    auto doubles = tensor({0.5, 2.0});
+    ASSERT_TENSORS_EQ(tensor({std::erf(0.5), std::erf(2.0)}), erf(doubles));
+}
+
+TEST(TensorOpsTestSuite, TestApplyMixedLayouts) {
+    Tensor<int> row_major({3, 4}, TensorOrder::RowMajor);
+    Tensor<int> col_major({3, 4}, TensorOrder::ColumnMajor);
+
+    fill(row_major, 1);
+    for (index_t i = 0; i < 3; i++) {
+        for (index_t j = 0; j < 4; j++) {
+            col_major(i, j) = int(i*4 + j);
+        }
+    }
+
+    auto expected = tensor({
+        { 1,  2,  3,  4},
+        { 5,  6,  7,  8},
+        { 9, 10, 11, 12}
+    });
+
+    ASSERT_TENSORS_EQ(expected, row_major + col_major);
+    ASSERT_TENSORS_EQ(expected, col_major + row_major);
+
+    // a row range is contiguous, but starts part way into storage
+    Tensor<int> rows = expected[{1, 3}];
+    ASSERT_TRUE(is_contiguous(rows.view()));
+
+    auto expected_rows = tensor({
+        {10, 12, 14, 16},
+        {18, 20, 22, 24}
+    });
+
+    ASSERT_TENSORS_EQ(expected_rows, rows + rows);
+}
+
+TEST(TensorOpsTestSuite, TestApplyTransposedAndSliced) {
+    Tensor<int> t({3, 4});
+    iota(t);
+
+    auto transposed = transpose(t, {1, 0});
+    auto expected = tensor({
+        {0,  8, 16},
+        {2, 10, 18},
+        {4, 12, 20},
+        {6, 14, 22}
+    });
+
+    ASSERT_TENSORS_EQ(expected, transposed + transposed.view(transposed.view()));
+    ASSERT_TENSORS_EQ(expected, copy(transposed) + transposed);
+
+    Tensor<int> columns = t[{0, 3}][{1, 3}];
+    auto expected_columns = tensor({
+        {1,  2},
+        {5,  6},
+        {9, 10}
+    });
+
+    ASSERT_TENSORS_EQ(expected_columns, copy(columns));
+    ASSERT_TENSORS_EQ(expected_columns, apply<int>(columns, [](int v) { return v; }));
+}
+
+TEST(TensorOpsTestSuite, TestExpressionIsLazy) {
+    auto a = tensor({1, 2, 3});
+    auto b = tensor({4, 5, 6});
+
+    auto expr = a + b;
+    static_assert(is_expression_v<decltype(expr)>);
+
+    // the expression reads storage at evaluation time
+    a(0) = 10;
+
+    Tensor<int> result = expr;
+    ASSERT_TENSORS_EQ(tensor({14, 7, 9}), result);
+}
+
+TEST(TensorOpsTestSuite, TestExpressionFused) {
+    auto a = tensor({
+        {1, 2, 3},
+        {4, 5, 6}
+    });
+    auto b = tensor({1, 1, 1});
+    auto c = tensor({{4}, {8}});
+    auto d = tensor({{2}, {4}});
+
+    Tensor<int> result = a + b - c / d + a.el() * a.el();
+
+    auto expected = tensor({
+        { 1,  5, 11},
+        {19, 29, 41}
+    });
+
+    ASSERT_EQ((extent{2, 3}), result.shape());
+    ASSERT_TENSORS_EQ(expected, result);
+    ASSERT_TENSORS_EQ(expected, eval(a + b - c / d + a.el() * a.el()));
+}
+
+TEST(TensorOpsTestSuite, TestExpressionInplace) {
+    auto a = tensor({1, 2, 3});
+    auto b = tensor({1, 1, 1});
+
+    a += b + b;
+    ASSERT_TENSORS_EQ(tensor({3, 4, 5}), a);
+
+    a -= b + tensor({1});
+    ASSERT_TENSORS_EQ(tensor({1, 2, 3}), a);
+
+    auto c = tensor({{1, 2, 3}, {4, 5, 6}});
+    EXPECT_THROW(a += c + b, MismatchedDimensions);
+}
+
+TEST(TensorOpsTestSuite, TestExpressionInplaceAliased) {
+    auto a = tensor({{0, 1}, {2, 3}});
+    auto b = tensor({{0, 0}, {0, 0}});
+
+    a += transpose(a, {1, 0}) + b;
+    ASSERT_TENSORS_EQ(tensor({{0, 3}, {3, 6}}), a);
+
+    a -= a + b;
+    ASSERT_TENSORS_EQ(tensor({{0, 0}, {0, 0}}), a);
+}
+
+TEST(TensorOpsTestSuite, TestExpressionInplaceAliasedBroadcast) {
+    auto a = tensor({{1, 2}, {3, 4}});
+    auto zeros = tensor({{0, 0}, {0, 0}});
+
+    Tensor<int> row = a[0];
+    a += row + zeros;
+    ASSERT_TENSORS_EQ(tensor({{2, 4}, {4, 6}}), a);
+}
+
+TEST(TensorOpsTestSuite, TestExpressionTransposed) {
+    Tensor<int> t({2, 3});
+    iota(t);
+
+    auto transposed = transpose(t, {1, 0});
+    Tensor<int> result = transposed + transposed - transposed;
+
+    auto expected = tensor({
+        {0, 3},
+        {1, 4},
+        {2, 5}
+    });
+
+    ASSERT_TENSORS_EQ(expected, result);
+}
+
+TEST(TensorOpsTestSuite, TestProductMatrixMatrixBlocked) {
+    // larger than one register tile and one cache block in every dimension
+    index_t m = 75, k = 260, n = 37;
+
+    Tensor<int> lhs({m, k});
+    Tensor<int> rhs({k, n});
+    fill(lhs, [i = 0]() mutable { return (i++ % 7) - 3; });
+    fill(rhs, [i = 0]() mutable { return (i++ % 5) - 2; });
+
+    Tensor<int> expected({m, n});
+    for (index_t i = 0; i < m; i++) {
+        for (index_t j = 0; j < n; j++) {
+            int sum = 0;
+            for (index_t p = 0; p < k; p++) {
+                sum += lhs(i, p)*rhs(p, j);
+            }
+            expected(i, j) = sum;
+        }
+    }
+
+    ASSERT_TENSORS_EQ(expected, lhs*rhs);
+
+    // transposed operands are read in place
+    auto lhs_t = copy(transpose(lhs, {1, 0}));
+    auto rhs_t = copy(transpose(rhs, {1, 0}));
+    ASSERT_TENSORS_EQ(expected, transpose(lhs_t, {1, 0})*transpose(rhs_t, {1, 0}));
+
+    EXPECT_THROW(lhs*lhs, MismatchedDimensions);
+}
+
+TEST(TensorOpsTestSuite, TestProductMatrixMatrixFloat) {
+    auto lhs = ones<float>({3, 4});
+    auto rhs = ones<float>({4, 2});
+
+    auto expected = tensor({
+        {4.0f, 4.0f},
+        {4.0f, 4.0f},
+        {4.0f, 4.0f}
+    });
+
+    ASSERT_TENSORS_EQ(expected, lhs*rhs);
+    ASSERT_TENSORS_EQ(zeros<float>({3, 2}), zeros<float>({3, 4})*rhs);
+}
+
+TEST(TensorOpsTestSuite, TestProductBlas) {
+    auto lhs = tensor<double, CPU_BLAS>({
+        {1, 2, 3},
+        {4, 5, 6}
+    });
+
+    auto rhs = tensor<double, CPU_BLAS>({
+        {1, 2},
+        {3, 4},
+        {5, 6}
+    });
+
+    auto expected = tensor<double, CPU_BLAS>({
+        {22, 28},
+        {49, 64}
+    });
+
+    ASSERT_TENSORS_EQ(expected, lhs*rhs);
+
+    // transposed operands are passed to BLAS without copying
+    auto lhs_t = transpose(tensor<double, CPU_BLAS>({{1, 4}, {2, 5}, {3, 6}}), {1, 0});
+    auto rhs_t = transpose(tensor<double, CPU_BLAS>({{1, 3, 5}, {2, 4, 6}}), {1, 0});
+    ASSERT_TENSORS_EQ(expected, lhs_t*rhs_t);
+
+    auto v = tensor<double, CPU_BLAS>({1, 2, 3});
+    ASSERT_TENSORS_EQ((tensor<double, CPU_BLAS>({14, 32})), lhs*v);
+    ASSERT_TENSORS_EQ((tensor<double, CPU_BLAS>({14, 32})), lhs_t*v);
+    ASSERT_TENSORS_EQ((tensor<double, CPU_BLAS>({14})), v*v);
+
+    EXPECT_THROW(lhs*lhs, MismatchedDimensions);
+}
+
+TEST(TensorOpsTestSuite, TestProductBlasFallback) {
+    // broadcast operands have zero strides, which BLAS cannot express
+    auto lhs = broadcast_to(tensor<float, CPU_BLAS>({1, 2, 3}), {2, 3});
+    auto rhs = ones<float, CPU_BLAS>({3, 2});
+
+    ASSERT_TENSORS_EQ((tensor<float, CPU_BLAS>({{6, 6}, {6, 6}})), lhs*rhs);
+
+    // element types BLAS does not support use the native kernels
+    auto ilhs = tensor<int, CPU_BLAS>({{1, 2}, {3, 4}});
+    ASSERT_TENSORS_EQ((tensor<int, CPU_BLAS>({{7, 10}, {15, 22}})), ilhs*ilhs);
+}
+
+TEST(TensorOpsTestSuite, TestProductBatchBroadcast) {
+    Tensor<int> lhs({2, 1, 3, 4});
+    Tensor<int> rhs({3, 4, 2});
+
+    iota(lhs);
+    iota(rhs);
+
+    ASSERT_EQ((extent{2, 3}), broadcast_shape({2, 1}, {3}));
+
+    // 2x1x3x4 * 3x4x2 => 2x3x3x2
+    auto result = lhs*rhs;
+    ASSERT_EQ((extent{2, 3, 3, 2}), result.shape());
+
+    for (index_t b0 = 0; b0 < 2; b0++) {
+        for (index_t b1 = 0; b1 < 3; b1++) {
+            for (index_t i = 0; i < 3; i++) {
+                for (index_t j = 0; j < 2; j++) {
+                    int expected = 0;
+                    for (index_t p = 0; p < 4; p++) {
+                        expected += lhs(b0, 0, i, p)*rhs(b1, p, j);
+                    }
+
+                    ASSERT_EQ(expected, result(b0, b1, i, j));
+                }
+            }
+        }
+    }
+
+    EXPECT_THROW(lhs*Tensor<int>({3, 2, 4, 2}), CannotBroadcast);
+    EXPECT_THROW(lhs*Tensor<int>({3, 3, 2}), MismatchedDimensions);
+}
+
+TEST(TensorOpsTestSuite, TestProductBatchStrided) {
+    Tensor<int> lhs({3, 2, 3, 4});
+    Tensor<int> rhs({2, 3, 4, 5});
+
+    iota(lhs);
+    iota(rhs);
+
+    // batch dimensions are permuted in place rather than copied
+    auto lhs_t = transpose(lhs, {1, 0, 2, 3});
+    ASSERT_TENSORS_EQ(copy(lhs_t)*rhs, lhs_t*rhs);
+
+    auto v = tensor({1, 2, 3, 4});
+    auto result = lhs*v;
+    ASSERT_EQ((extent{3, 2, 3}), result.shape());
+    ASSERT_EQ(lhs(2, 1, 2, 0) + 2*lhs(2, 1, 2, 1) + 3*lhs(2, 1, 2, 2) + 4*lhs(2, 1, 2, 3),
+              result(2, 1, 2));
+
+    auto w = tensor({1, 2, 3, 4});
+    auto result2 = w*rhs;
+    ASSERT_EQ((extent{2, 3, 5}), result2.shape());
+    ASSERT_EQ(rhs(1, 2, 0, 4) + 2*rhs(1, 2, 1, 4) + 3*rhs(1, 2, 2, 4) + 4*rhs(1, 2, 3, 4),
+              result2(1, 2, 4));
+}
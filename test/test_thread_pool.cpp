@@ -0,0 +1,116 @@
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <fmt/format.h>
+#include <fmt/ranges.h>
+
+#include "tensor.hpp"
+#include "tensor_ops.hpp"
+#include "thread_pool.hpp"
+
+#define ASSERT_TENSORS_EQ(expected, result) \
+    ASSERT_TRUE(equals(expected, result))
+
+TEST(ThreadPoolTestSuite, TestParallelForCoversRange) {
+    ThreadPool pool(4);
+    std::vector<std::atomic<int>> visits(1000);
+
+    pool.parallel_for(0, visits.size(), 10, [&visits](index_t begin, index_t end) {
+        for (index_t i = begin; i < end; i++) {
+            ++visits[i];
+        }
+    });
+
+    for (auto &count : visits) {
+        ASSERT_EQ(1, count);
+    }
+}
+
+TEST(ThreadPoolTestSuite, TestParallelForSerialBelowGrain) {
+    ThreadPool pool(4);
+    std::size_t calls = 0;
+
+    pool.parallel_for(0, 100, 100, [&calls](index_t begin, index_t end) {
+        ASSERT_EQ(0, begin);
+        ASSERT_EQ(100, end);
+        ++calls;
+    });
+
+    ASSERT_EQ(1, calls);
+}
+
+TEST(ThreadPoolTestSuite, TestParallelForNested) {
+    ThreadPool pool(4);
+    std::atomic<index_t> total{0};
+
+    pool.parallel_for(0, 16, 1, [&](index_t begin, index_t end) {
+        for (index_t i = begin; i < end; i++) {
+            pool.parallel_for(0, 16, 1, [&](index_t inner_begin, index_t inner_end) {
+                total += inner_end - inner_begin;
+            });
+        }
+    });
+
+    ASSERT_EQ(16*16, total);
+}
+
+TEST(ThreadPoolTestSuite, TestParallelForRethrows) {
+    ThreadPool pool(4);
+
+    EXPECT_THROW(pool.parallel_for(0, 100, 1, [](index_t begin, index_t end) {
+        if (begin <= 50 && 50 < end) throw std::runtime_error("failed");
+    }), std::runtime_error);
+}
+
+TEST(ThreadPoolTestSuite, TestParallelElementwise) {
+    auto grain_size = parallel_grain_size();
+    parallel_grain_size() = 16;
+
+    Tensor<int> lhs({64, 33});
+    Tensor<int> rhs({64, 33});
+    iota(lhs);
+    fill(rhs, 2);
+
+    Tensor<int> expected({64, 33});
+    iota(expected, 2, 1);
+
+    ASSERT_TENSORS_EQ(expected, lhs + rhs);
+    ASSERT_TENSORS_EQ(expected, apply<int>(lhs, [](int v) { return v + 2; }));
+
+    // strided path
+    auto transposed = transpose(lhs, {1, 0});
+    Tensor<int> doubled = transposed + transposed;
+    for (index_t i = 0; i < 33; i++) {
+        for (index_t j = 0; j < 64; j++) {
+            ASSERT_EQ(2*lhs(j, i), doubled(i, j));
+        }
+    }
+
+    parallel_grain_size() = grain_size;
+}
+
+TEST(ThreadPoolTestSuite, TestParallelProduct) {
+    auto grain_size = parallel_grain_size();
+    parallel_grain_size() = 1;
+
+    Tensor<int> lhs({2, 3, 4});
+    Tensor<int> rhs({2, 4, 6});
+    iota(lhs);
+    iota(rhs);
+
+    auto expected = tensor({
+        {{84,  90,  96, 102, 108, 114},
+         {228, 250, 272, 294, 316, 338},
+         {372, 410, 448, 486, 524, 562}},
+
+        {{1812, 1866, 1920, 1974, 2028, 2082},
+         {2340, 2410, 2480, 2550, 2620, 2690},
+         {2868, 2954, 3040, 3126, 3212, 3298}}
+    });
+
+    ASSERT_TENSORS_EQ(expected, lhs*rhs);
+
+    parallel_grain_size() = grain_size;
+}